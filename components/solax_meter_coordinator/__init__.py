@@ -0,0 +1,95 @@
+import esphome.codegen as cg
+from esphome.components import sensor, solax_meter_gateway
+import esphome.config_validation as cv
+from esphome.const import CONF_ID
+import esphome.final_validate as fv
+
+CODEOWNERS = ["@syssi"]
+
+DEPENDENCIES = ["solax_meter_gateway"]
+MULTI_CONF = True
+
+CONF_POWER_ID = "power_id"
+CONF_STRATEGY = "strategy"
+CONF_HYSTERESIS = "hysteresis"
+CONF_RELEASE_TIMEOUT = "release_timeout"
+CONF_GATEWAYS = "gateways"
+CONF_RATED_POWER = "rated_power"
+
+solax_meter_coordinator_ns = cg.esphome_ns.namespace("solax_meter_coordinator")
+SolaxMeterCoordinator = solax_meter_coordinator_ns.class_(
+    "SolaxMeterCoordinator", cg.Component
+)
+
+CoordinatorStrategy = solax_meter_coordinator_ns.enum("CoordinatorStrategy")
+COORDINATOR_STRATEGIES = {
+    "weighted": CoordinatorStrategy.STRATEGY_WEIGHTED,
+    "round_robin": CoordinatorStrategy.STRATEGY_ROUND_ROBIN,
+    "least_recently_polled": CoordinatorStrategy.STRATEGY_LEAST_RECENTLY_POLLED,
+}
+
+GATEWAY_SCHEMA = cv.Schema(
+    {
+        cv.Required(solax_meter_gateway.CONF_SOLAX_METER_GATEWAY_ID): cv.use_id(
+            solax_meter_gateway.SolaxMeterGateway
+        ),
+        cv.Optional(
+            CONF_RATED_POWER, default=solax_meter_gateway.DEFAULT_MAX_POWER_DEMAND
+        ): cv.positive_not_null_float,
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(SolaxMeterCoordinator),
+        cv.Required(CONF_POWER_ID): cv.use_id(sensor.Sensor),
+        cv.Optional(CONF_STRATEGY, default="weighted"): cv.enum(
+            COORDINATOR_STRATEGIES, lower=True
+        ),
+        cv.Optional(CONF_HYSTERESIS, default=0.0): cv.positive_float,
+        cv.Optional(
+            CONF_RELEASE_TIMEOUT, default="10s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Required(CONF_GATEWAYS): cv.All(
+            cv.ensure_list(GATEWAY_SCHEMA), cv.Length(min=1, max=8)
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+
+def validate_gateway_without_filter(gateway_config):
+    # The coordinator replaces the filtered power sensor as source of the power demand
+    if solax_meter_gateway.CONF_POWER_DEMAND_FILTER in gateway_config:
+        raise cv.Invalid(
+            f"{solax_meter_gateway.CONF_POWER_DEMAND_FILTER} isn't applied to the share "
+            "assigned by a coordinator, remove it from the gateway"
+        )
+    return gateway_config
+
+
+def final_validate_gateways(config):
+    for gateway_config in config[CONF_GATEWAYS]:
+        fv.id_declaration_match_schema(validate_gateway_without_filter)(
+            gateway_config[solax_meter_gateway.CONF_SOLAX_METER_GATEWAY_ID]
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate_gateways
+
+
+async def to_code(config):
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+
+    power_sensor = await cg.get_variable(config[CONF_POWER_ID])
+    cg.add(var.set_power_sensor(power_sensor))
+    cg.add(var.set_strategy(config[CONF_STRATEGY]))
+    cg.add(var.set_hysteresis(config[CONF_HYSTERESIS]))
+    cg.add(var.set_release_timeout(config[CONF_RELEASE_TIMEOUT]))
+
+    for gateway_config in config[CONF_GATEWAYS]:
+        gateway = await cg.get_variable(
+            gateway_config[solax_meter_gateway.CONF_SOLAX_METER_GATEWAY_ID]
+        )
+        cg.add(var.add_gateway(gateway, gateway_config[CONF_RATED_POWER]))
@@ -0,0 +1,109 @@
+#include "solax_meter_coordinator.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace esphome::solax_meter_coordinator {
+
+static const char *const TAG = "solax_meter_coordinator";
+
+void SolaxMeterCoordinator::add_gateway(solax_meter_gateway::SolaxMeterGateway *gateway, float rated_power) {
+  if (this->gateways_len_ >= MAX_COORDINATED_GATEWAYS) {
+    ESP_LOGE(TAG, "Too many gateways. Only %u are supported", MAX_COORDINATED_GATEWAYS);
+    return;
+  }
+
+  uint8_t index = this->gateways_len_++;
+  this->gateways_[index] = {rated_power, 0.0f, 0};
+  this->total_rated_power_ += rated_power;
+  gateway->set_power_demand_source([this, index]() { return this->get_power_demand(index); });
+  gateway->set_power_poll_callback([this, index]() { this->poll(index, millis()); });
+}
+
+void SolaxMeterCoordinator::set_power_demand(float power_demand, uint32_t now) {
+  this->power_demand_ = power_demand;
+
+  // Release the share of gateways whose inverter stopped polling and resync the sum
+  this->assigned_power_demand_ = 0.0f;
+  for (uint8_t i = 0; i < this->gateways_len_; i++) {
+    CoordinatedGateway &gateway = this->gateways_[i];
+    if (now - gateway.last_poll > this->release_timeout_) {
+      gateway.share = 0.0f;
+    }
+    this->assigned_power_demand_ += gateway.share;
+  }
+}
+
+float SolaxMeterCoordinator::get_power_demand(uint8_t index) const {
+  if (std::isnan(this->power_demand_)) {
+    return NAN;
+  }
+
+  return this->target_share_(index);
+}
+
+float SolaxMeterCoordinator::poll(uint8_t index, uint32_t now) {
+  CoordinatedGateway &gateway = this->gateways_[index];
+  gateway.last_poll = now;
+  if (std::isnan(this->power_demand_)) {
+    return NAN;
+  }
+
+  float share = this->target_share_(index);
+  this->assigned_power_demand_ += share - gateway.share;
+  gateway.share = share;
+
+  if (this->strategy_ == STRATEGY_ROUND_ROBIN && index == this->next_gateway_) {
+    this->next_gateway_ = (this->next_gateway_ + 1) % this->gateways_len_;
+  }
+
+  return gateway.share;
+}
+
+float SolaxMeterCoordinator::target_share_(uint8_t index) const {
+  const CoordinatedGateway &gateway = this->gateways_[index];
+  float target;
+  switch (this->strategy_) {
+    case STRATEGY_WEIGHTED:
+      target = this->power_demand_ * gateway.rated_power / this->total_rated_power_;
+      break;
+    case STRATEGY_ROUND_ROBIN:
+      // Only the gateway holding the turn corrects the remaining deficit
+      if (index != this->next_gateway_) {
+        return gateway.share;
+      }
+      target = gateway.share + this->power_demand_ - this->assigned_power_demand_;
+      break;
+    default:
+      // The next polling gateway has the oldest reading and takes the remaining deficit
+      target = gateway.share + this->power_demand_ - this->assigned_power_demand_;
+      break;
+  }
+  target = std::max(0.0f, std::min(target, gateway.rated_power));
+
+  if (std::fabs(target - gateway.share) <= this->hysteresis_) {
+    return gateway.share;
+  }
+  return target;
+}
+
+void SolaxMeterCoordinator::setup() {
+  this->power_sensor_->add_on_state_callback([this](float state) {
+    if (std::isnan(state)) {
+      return;
+    }
+    this->set_power_demand(state, millis());
+  });
+}
+
+void SolaxMeterCoordinator::dump_config() {
+  ESP_LOGCONFIG(TAG, "SolaxMeterCoordinator:");
+  ESP_LOGCONFIG(TAG, "  Strategy: %u", this->strategy_);
+  ESP_LOGCONFIG(TAG, "  Hysteresis: %.0f W", this->hysteresis_);
+  for (uint8_t i = 0; i < this->gateways_len_; i++) {
+    ESP_LOGCONFIG(TAG, "  Gateway %u: rated power %.0f W", i, this->gateways_[i].rated_power);
+  }
+}
+
+}  // namespace esphome::solax_meter_coordinator
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/solax_meter_gateway/solax_meter_gateway.h"
+
+namespace esphome::solax_meter_coordinator {
+
+enum CoordinatorStrategy : uint8_t {
+  STRATEGY_WEIGHTED,
+  STRATEGY_ROUND_ROBIN,
+  STRATEGY_LEAST_RECENTLY_POLLED,
+};
+
+static const uint8_t MAX_COORDINATED_GATEWAYS = 8;
+
+struct CoordinatedGateway {
+  float rated_power;
+  float share;
+  uint32_t last_poll;
+};
+
+// Splits one measured power demand across several gateways, so parallel inverters
+// don't all react to the full deficit. Every poll of a gateway is answered in O(1).
+class SolaxMeterCoordinator : public Component {
+ public:
+  void set_power_sensor(sensor::Sensor *power_sensor) { power_sensor_ = power_sensor; }
+  void set_strategy(CoordinatorStrategy strategy) { this->strategy_ = strategy; }
+  void set_hysteresis(float hysteresis) { this->hysteresis_ = hysteresis; }
+  void set_release_timeout(uint32_t release_timeout) { this->release_timeout_ = release_timeout; }
+
+  void add_gateway(solax_meter_gateway::SolaxMeterGateway *gateway, float rated_power);
+
+  void set_power_demand(float power_demand, uint32_t now);
+  // Share the gateway would get if its inverter polled right now. Doesn't change anything
+  float get_power_demand(uint8_t index) const;
+  // The inverter of the gateway polled the power: assigns and returns its share
+  float poll(uint8_t index, uint32_t now);
+
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::DATA; }
+
+ protected:
+  float target_share_(uint8_t index) const;
+
+  sensor::Sensor *power_sensor_{nullptr};
+  CoordinatorStrategy strategy_{STRATEGY_WEIGHTED};
+  float hysteresis_{0.0f};
+  uint32_t release_timeout_{10000};
+
+  CoordinatedGateway gateways_[MAX_COORDINATED_GATEWAYS]{};
+  uint8_t gateways_len_{0};
+  float total_rated_power_{0.0f};
+  float power_demand_{NAN};
+  float assigned_power_demand_{0.0f};
+  uint8_t next_gateway_{0};
+};
+
+}  // namespace esphome::solax_meter_coordinator
@@ -1,7 +1,7 @@
 import esphome.codegen as cg
 from esphome.components import sensor, solax_meter_modbus
 import esphome.config_validation as cv
-from esphome.const import CONF_ID
+from esphome.const import CONF_ID, CONF_TYPE
 
 CODEOWNERS = ["@syssi"]
 
@@ -13,9 +13,23 @@ CONF_SOLAX_METER_GATEWAY_ID = "solax_meter_gateway_id"
 CONF_POWER_ID = "power_id"
 CONF_POWER_SENSOR_INACTIVITY_TIMEOUT = "power_sensor_inactivity_timeout"
 CONF_OPERATION_MODE_ID = "operation_mode_id"
+CONF_LOW_LATENCY_REPLY = "low_latency_reply"
+CONF_ENERGY_SAVE_INTERVAL = "energy_save_interval"
+CONF_POWER_DEMAND_FILTER = "power_demand_filter"
+CONF_ALPHA = "alpha"
+CONF_WINDOW_SIZE = "window_size"
+CONF_MAX_EXTRAPOLATION = "max_extrapolation"
+CONF_REGULATION = "regulation"
+CONF_SETPOINT = "setpoint"
+CONF_KP = "kp"
+CONF_KI = "ki"
+CONF_MIN_POWER_DEMAND = "min_power_demand"
+CONF_MAX_POWER_DEMAND = "max_power_demand"
 
 DEFAULT_MIN_POWER_DEMAND = 0
 DEFAULT_MAX_POWER_DEMAND = 600
+DEFAULT_KP = 1.5
+DEFAULT_KI = 1.0
 
 solax_meter_gateway_ns = cg.esphome_ns.namespace("solax_meter_gateway")
 SolaxMeterGateway = solax_meter_gateway_ns.class_(
@@ -24,6 +38,53 @@ SolaxMeterGateway = solax_meter_gateway_ns.class_(
     solax_meter_modbus.SolaxMeterModbusDevice,
 )
 
+PowerDemandFilterType = solax_meter_gateway_ns.enum("PowerDemandFilterType")
+POWER_DEMAND_FILTER_TYPES = {
+    "none": PowerDemandFilterType.FILTER_NONE,
+    "ema": PowerDemandFilterType.FILTER_EMA,
+    "median": PowerDemandFilterType.FILTER_MEDIAN,
+    "extrapolate": PowerDemandFilterType.FILTER_EXTRAPOLATE,
+}
+
+POWER_DEMAND_FILTER_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_TYPE): cv.enum(POWER_DEMAND_FILTER_TYPES, lower=True),
+        cv.Optional(CONF_ALPHA, default=0.5): cv.float_range(
+            min=0.0, max=1.0, min_included=False
+        ),
+        cv.Optional(CONF_WINDOW_SIZE, default=5): cv.int_range(min=1, max=16),
+        cv.Optional(
+            CONF_MAX_EXTRAPOLATION, default="3s"
+        ): cv.positive_time_period_milliseconds,
+    }
+)
+
+
+def validate_power_demand_limits(config):
+    if config[CONF_MIN_POWER_DEMAND] >= config[CONF_MAX_POWER_DEMAND]:
+        raise cv.Invalid(
+            f"{CONF_MIN_POWER_DEMAND} must be less than {CONF_MAX_POWER_DEMAND}"
+        )
+    return config
+
+
+REGULATION_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(CONF_SETPOINT, default=0.0): cv.float_,
+            cv.Optional(CONF_KP, default=DEFAULT_KP): cv.positive_float,
+            cv.Optional(CONF_KI, default=DEFAULT_KI): cv.positive_float,
+            cv.Optional(
+                CONF_MIN_POWER_DEMAND, default=DEFAULT_MIN_POWER_DEMAND
+            ): cv.float_,
+            cv.Optional(
+                CONF_MAX_POWER_DEMAND, default=DEFAULT_MAX_POWER_DEMAND
+            ): cv.float_,
+        }
+    ),
+    validate_power_demand_limits,
+)
+
 CONF_SOLAX_METER_GATEWAY_COMPONENT_SCHEMA = cv.Schema(
     {
         cv.GenerateID(CONF_SOLAX_METER_GATEWAY_ID): cv.use_id(SolaxMeterGateway),
@@ -38,6 +99,12 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(
                 CONF_POWER_SENSOR_INACTIVITY_TIMEOUT, default="5s"
             ): cv.positive_time_period_seconds,
+            cv.Optional(CONF_LOW_LATENCY_REPLY, default=False): cv.boolean,
+            cv.Optional(
+                CONF_ENERGY_SAVE_INTERVAL, default="5min"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_POWER_DEMAND_FILTER): POWER_DEMAND_FILTER_SCHEMA,
+            cv.Optional(CONF_REGULATION): REGULATION_SCHEMA,
         }
     )
     .extend(solax_meter_modbus.solax_meter_modbus_device_schema(0x01))
@@ -58,3 +125,27 @@ async def to_code(config):
             config[CONF_POWER_SENSOR_INACTIVITY_TIMEOUT]
         )
     )
+    cg.add(var.set_low_latency_reply(config[CONF_LOW_LATENCY_REPLY]))
+    cg.add(var.set_energy_save_interval(config[CONF_ENERGY_SAVE_INTERVAL]))
+    cg.add(var.set_energy_key(config[CONF_ID].id))
+
+    if power_demand_filter := config.get(CONF_POWER_DEMAND_FILTER):
+        cg.add(
+            var.set_power_demand_filter(
+                power_demand_filter[CONF_TYPE],
+                power_demand_filter[CONF_ALPHA],
+                power_demand_filter[CONF_WINDOW_SIZE],
+                power_demand_filter[CONF_MAX_EXTRAPOLATION],
+            )
+        )
+
+    if regulation := config.get(CONF_REGULATION):
+        cg.add(
+            var.set_power_demand_controller(
+                regulation[CONF_SETPOINT],
+                regulation[CONF_KP],
+                regulation[CONF_KI],
+                regulation[CONF_MIN_POWER_DEMAND],
+                regulation[CONF_MAX_POWER_DEMAND],
+            )
+        )
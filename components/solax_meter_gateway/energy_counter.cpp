@@ -0,0 +1,58 @@
+#include "energy_counter.h"
+
+namespace esphome::solax_meter_gateway {
+
+static const double MS_PER_HOUR = 3600000.0;
+
+void EnergyCounter::add_sample(float power, uint32_t timestamp) {
+  if (std::isnan(power)) {
+    this->interrupt();
+    return;
+  }
+
+  float last_power = this->last_power_;
+  uint32_t elapsed = timestamp - this->last_timestamp_;
+  this->last_power_ = power;
+  this->last_timestamp_ = timestamp;
+
+  // Don't bridge outages of the inverter polling
+  if (std::isnan(last_power) || elapsed == 0 || elapsed > this->max_gap_) {
+    return;
+  }
+
+  double hours = elapsed / MS_PER_HOUR;
+  if ((last_power >= 0.0f) == (power >= 0.0f)) {
+    this->accumulate_((last_power + power) / 2.0f, hours);
+  } else {
+    // Split the trapezoid into two triangles at the zero crossing
+    double crossing = last_power / (last_power - power);
+    this->accumulate_(last_power / 2.0f, hours * crossing);
+    this->accumulate_(power / 2.0f, hours * (1.0 - crossing));
+  }
+  this->unsaved_ = true;
+}
+
+void EnergyCounter::accumulate_(float power, double hours) {
+  if (power >= 0.0f) {
+    this->import_wh_ += power * hours;
+  } else {
+    this->export_wh_ -= power * hours;
+  }
+}
+
+void EnergyCounter::restore(const EnergyCounterState &state) {
+  this->import_wh_ = state.import_wh;
+  this->export_wh_ = state.export_wh;
+  this->unsaved_ = false;
+}
+
+bool EnergyCounter::is_save_due(uint32_t now) const {
+  return this->unsaved_ && now - this->last_save_ >= this->save_interval_;
+}
+
+void EnergyCounter::mark_saved(uint32_t now) {
+  this->last_save_ = now;
+  this->unsaved_ = false;
+}
+
+}  // namespace esphome::solax_meter_gateway
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome::solax_meter_gateway {
+
+// Persisted state of the energy counters
+struct EnergyCounterState {
+  double import_wh;
+  double export_wh;
+};
+
+// Integrates the measured power into import (positive power) and export (negative power)
+// energy counters using the trapezoidal rule.
+class EnergyCounter {
+ public:
+  void set_max_gap(uint32_t max_gap) { this->max_gap_ = max_gap; }
+  void set_save_interval(uint32_t save_interval) { this->save_interval_ = save_interval; }
+
+  void add_sample(float power, uint32_t timestamp);
+  // The next sample starts a new integration interval
+  void interrupt() { this->last_power_ = NAN; }
+  float get_last_power() const { return this->last_power_; }
+
+  void restore(const EnergyCounterState &state);
+  EnergyCounterState get_state() const { return {this->import_wh_, this->export_wh_}; }
+  float get_import_kwh() const { return this->import_wh_ / 1000.0; }
+  float get_export_kwh() const { return this->export_wh_ / 1000.0; }
+
+  // True if the counters changed and the last save is at least one save interval ago
+  bool is_save_due(uint32_t now) const;
+  bool has_unsaved_changes() const { return this->unsaved_; }
+  void mark_saved(uint32_t now);
+
+ protected:
+  void accumulate_(float power, double hours);
+
+  double import_wh_{0.0};
+  double export_wh_{0.0};
+  float last_power_{NAN};
+  uint32_t last_timestamp_{0};
+  uint32_t max_gap_{60000};
+
+  uint32_t save_interval_{300000};
+  uint32_t last_save_{0};
+  bool unsaved_{false};
+};
+
+}  // namespace esphome::solax_meter_gateway
@@ -0,0 +1,34 @@
+#include "power_demand_controller.h"
+
+#include <algorithm>
+
+namespace esphome::solax_meter_gateway {
+
+// Upper bound of the integration step if the inverter stops polling for a while
+static const float MAX_TIME_STEP = 5.0f;
+
+float PowerDemandController::update(float grid_power, uint32_t now) {
+  float error = grid_power - this->setpoint_;
+  float dt = this->running_ ? std::min((now - this->last_update_) / 1000.0f, MAX_TIME_STEP) : 0.0f;
+  this->last_update_ = now;
+  this->running_ = true;
+
+  // Anti-windup: stop integrating while the output is saturated in the direction of the error
+  float output = this->kp_ * error + this->integral_;
+  bool saturated_high = output >= this->max_power_demand_ && error > 0.0f;
+  bool saturated_low = output <= this->min_power_demand_ && error < 0.0f;
+  if (!saturated_high && !saturated_low) {
+    this->integral_ += this->ki_ * error * dt;
+    this->integral_ = std::max(this->min_power_demand_, std::min(this->integral_, this->max_power_demand_));
+  }
+
+  output = this->kp_ * error + this->integral_;
+  return std::max(this->min_power_demand_, std::min(output, this->max_power_demand_));
+}
+
+void PowerDemandController::reset() {
+  this->integral_ = 0.0f;
+  this->running_ = false;
+}
+
+}  // namespace esphome::solax_meter_gateway
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome::solax_meter_gateway {
+
+// PI controller which regulates the measured grid power to a setpoint
+// by adjusting the power demand reported to the inverter.
+class PowerDemandController {
+ public:
+  void set_setpoint(float setpoint) { this->setpoint_ = setpoint; }
+  void set_gains(float kp, float ki) {
+    this->kp_ = kp;
+    this->ki_ = ki;
+  }
+  void set_limits(float min_power_demand, float max_power_demand) {
+    this->min_power_demand_ = min_power_demand;
+    this->max_power_demand_ = max_power_demand;
+  }
+
+  // Returns the power demand for the measured grid power (positive: import)
+  float update(float grid_power, uint32_t now);
+  void reset();
+
+  float get_integral() const { return this->integral_; }
+
+ protected:
+  float setpoint_{0.0f};
+  float kp_{1.5f};
+  float ki_{1.0f};
+  float min_power_demand_{0.0f};
+  float max_power_demand_{600.0f};
+
+  float integral_{0.0f};
+  uint32_t last_update_{0};
+  bool running_{false};
+};
+
+}  // namespace esphome::solax_meter_gateway
@@ -0,0 +1,91 @@
+#include "power_demand_filter.h"
+
+#include <algorithm>
+
+namespace esphome::solax_meter_gateway {
+
+void PowerDemandFilter::add_sample(float value, uint32_t timestamp) {
+  this->samples_[this->head_] = {value, timestamp};
+  this->head_ = (this->head_ + 1) % MAX_POWER_SAMPLES;
+  if (this->count_ < MAX_POWER_SAMPLES)
+    this->count_++;
+  if (this->pending_ < MAX_POWER_SAMPLES)
+    this->pending_++;
+}
+
+const PowerSample &PowerDemandFilter::sample_(uint8_t age) const {
+  // age 0 is the latest sample
+  return this->samples_[(this->head_ + MAX_POWER_SAMPLES - 1 - age) % MAX_POWER_SAMPLES];
+}
+
+float PowerDemandFilter::evaluate(uint32_t now) {
+  if (this->count_ == 0)
+    return NAN;
+
+  switch (this->type_) {
+    case FILTER_EMA:
+      return this->evaluate_ema_();
+    case FILTER_MEDIAN:
+      return this->evaluate_median_();
+    case FILTER_EXTRAPOLATE:
+      return this->evaluate_extrapolation_(now);
+    case FILTER_NONE:
+    default:
+      return this->sample_(0).value;
+  }
+}
+
+float PowerDemandFilter::evaluate_ema_() {
+  // Fold in the samples received since the last poll, oldest first
+  while (this->pending_ > 0) {
+    this->pending_--;
+    float value = this->sample_(this->pending_).value;
+    this->ema_ = std::isnan(this->ema_) ? value : this->ema_ + this->alpha_ * (value - this->ema_);
+  }
+  return this->ema_;
+}
+
+float PowerDemandFilter::evaluate_median_() {
+  uint8_t n = std::min(this->window_size_, this->count_);
+  float values[MAX_POWER_SAMPLES];
+  for (uint8_t i = 0; i < n; i++)
+    values[i] = this->sample_(i).value;
+  std::sort(values, values + n);
+
+  if (n % 2 == 1)
+    return values[n / 2];
+  return (values[n / 2 - 1] + values[n / 2]) / 2.0f;
+}
+
+float PowerDemandFilter::evaluate_extrapolation_(uint32_t now) {
+  const PowerSample &latest = this->sample_(0);
+  uint8_t n = std::min(this->window_size_, this->count_);
+  if (n < 2)
+    return latest.value;
+
+  // Least squares line through the window, time in seconds relative to the latest sample
+  float mean_t = 0.0f;
+  float mean_v = 0.0f;
+  for (uint8_t i = 0; i < n; i++) {
+    mean_t -= (latest.timestamp - this->sample_(i).timestamp) / 1000.0f;
+    mean_v += this->sample_(i).value;
+  }
+  mean_t /= n;
+  mean_v /= n;
+
+  float covariance = 0.0f;
+  float variance = 0.0f;
+  for (uint8_t i = 0; i < n; i++) {
+    float dt = -((latest.timestamp - this->sample_(i).timestamp) / 1000.0f) - mean_t;
+    covariance += dt * (this->sample_(i).value - mean_v);
+    variance += dt * dt;
+  }
+  if (variance == 0.0f)
+    return latest.value;
+
+  // Don't extrapolate beyond the configured horizon if the power sensor stalls
+  float horizon = std::min(now - latest.timestamp, this->max_extrapolation_) / 1000.0f;
+  return mean_v + (covariance / variance) * (horizon - mean_t);
+}
+
+}  // namespace esphome::solax_meter_gateway
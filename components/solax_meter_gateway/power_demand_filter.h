@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome::solax_meter_gateway {
+
+enum PowerDemandFilterType : uint8_t {
+  FILTER_NONE,
+  FILTER_EMA,
+  FILTER_MEDIAN,
+  FILTER_EXTRAPOLATE,
+};
+
+static const uint8_t MAX_POWER_SAMPLES = 16;
+
+struct PowerSample {
+  float value;
+  uint32_t timestamp;
+};
+
+// Smooths or predicts the power demand from timestamped power sensor samples.
+// Samples are only stored on arrival, the filter runs when the inverter polls.
+class PowerDemandFilter {
+ public:
+  void set_type(PowerDemandFilterType type) { this->type_ = type; }
+  void set_alpha(float alpha) { this->alpha_ = alpha; }
+  void set_window_size(uint8_t window_size) { this->window_size_ = window_size; }
+  void set_max_extrapolation(uint32_t max_extrapolation) { this->max_extrapolation_ = max_extrapolation; }
+  PowerDemandFilterType get_type() const { return this->type_; }
+
+  void add_sample(float value, uint32_t timestamp);
+  // Returns NAN if no sample was received yet
+  float evaluate(uint32_t now);
+
+ protected:
+  const PowerSample &sample_(uint8_t age) const;
+  float evaluate_ema_();
+  float evaluate_median_();
+  float evaluate_extrapolation_(uint32_t now);
+
+  PowerDemandFilterType type_{FILTER_NONE};
+  float alpha_{0.5f};
+  uint8_t window_size_{5};
+  uint32_t max_extrapolation_{3000};
+
+  PowerSample samples_[MAX_POWER_SAMPLES];
+  uint8_t head_{0};
+  uint8_t count_{0};
+  // Samples not folded into the moving average yet
+  uint8_t pending_{0};
+  float ema_{NAN};
+};
+
+}  // namespace esphome::solax_meter_gateway
@@ -2,9 +2,15 @@ import esphome.codegen as cg
 from esphome.components import sensor
 import esphome.config_validation as cv
 from esphome.const import (
+    DEVICE_CLASS_DURATION,
+    DEVICE_CLASS_ENERGY,
     DEVICE_CLASS_POWER,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     ICON_EMPTY,
+    ICON_TIMER,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_KILOWATT_HOURS,
     UNIT_WATT,
 )
 
@@ -14,6 +20,11 @@ DEPENDENCIES = ["solax_meter_gateway"]
 CODEOWNERS = ["@syssi"]
 
 CONF_POWER_DEMAND = "power_demand"
+CONF_TURNAROUND_TIME = "turnaround_time"
+CONF_ENERGY_IMPORT = "energy_import"
+CONF_ENERGY_EXPORT = "energy_export"
+
+UNIT_MICROSECOND = "µs"
 
 SENSOR_DEFS = {
     CONF_POWER_DEMAND: {
@@ -23,6 +34,28 @@ SENSOR_DEFS = {
         "device_class": DEVICE_CLASS_POWER,
         "state_class": STATE_CLASS_MEASUREMENT,
     },
+    CONF_TURNAROUND_TIME: {
+        "unit_of_measurement": UNIT_MICROSECOND,
+        "icon": ICON_TIMER,
+        "accuracy_decimals": 0,
+        "device_class": DEVICE_CLASS_DURATION,
+        "state_class": STATE_CLASS_MEASUREMENT,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_ENERGY_IMPORT: {
+        "unit_of_measurement": UNIT_KILOWATT_HOURS,
+        "icon": ICON_EMPTY,
+        "accuracy_decimals": 3,
+        "device_class": DEVICE_CLASS_ENERGY,
+        "state_class": STATE_CLASS_TOTAL_INCREASING,
+    },
+    CONF_ENERGY_EXPORT: {
+        "unit_of_measurement": UNIT_KILOWATT_HOURS,
+        "icon": ICON_EMPTY,
+        "accuracy_decimals": 3,
+        "device_class": DEVICE_CLASS_ENERGY,
+        "state_class": STATE_CLASS_TOTAL_INCREASING,
+    },
 }
 
 CONFIG_SCHEMA = CONF_SOLAX_METER_GATEWAY_COMPONENT_SCHEMA.extend(
@@ -5,89 +5,261 @@ namespace esphome::solax_meter_gateway {
 
 static const char *const TAG = "solax_meter_gateway";
 
-static const uint8_t REGISTER_HANDSHAKE = 0x0B;
-static const uint8_t REGISTER_READ_POWER_16BIT_SINT = 0x0E;
-static const uint8_t REGISTER_READ_POWER_32BIT_FLOAT = 0x0C;
-static const uint8_t REGISTER_READ_TOTAL_ENERGY = 0x08;
-static const uint8_t REGISTER_READ_TOTAL_ENERGY_IMPORT_32BIT_FLOAT = 0x48;
-static const uint8_t REGISTER_READ_TOTAL_ENERGY_EXPORT_32BIT_FLOAT = 0x4A;
-
-void SolaxMeterGateway::on_solax_meter_modbus_data(const std::vector<uint8_t> &data) {
-  this->last_power_demand_received_ = millis();
-
-  if (this->inactivity_timeout_()) {
-    this->publish_state_(this->operation_mode_text_sensor_, "Meter fault");
+using solax_meter_modbus::MeterRegister;
+using solax_meter_modbus::METER_REGISTER_FLOAT32;
+using solax_meter_modbus::METER_REGISTER_INT16;
+using solax_meter_modbus::METER_REGISTER_RESERVED;
+
+enum MeterValue : uint8_t {
+  METER_VALUE_NONE,
+  METER_VALUE_VOLTAGE,
+  METER_VALUE_CURRENT,
+  METER_VALUE_POWER,
+  METER_VALUE_APPARENT_POWER,
+  METER_VALUE_POWER_FACTOR,
+  METER_VALUE_FREQUENCY,
+  METER_VALUE_ENERGY_IMPORT,
+  METER_VALUE_ENERGY_EXPORT,
+  METER_VALUE_TOTAL_ENERGY,
+};
+
+static const uint16_t REGISTER_POWER_32BIT_FLOAT = 0x0C;
+static const uint16_t REGISTER_POWER_16BIT_SINT = 0x0E;
+
+static const float NOMINAL_VOLTAGE = 230.0f;
+static const float NOMINAL_FREQUENCY = 50.0f;
+
+// Input registers of a SDM230 plus the registers polled by the Solax X1 mini variants:
+//
+// Handshake request:        0x01 0x03 0x00 0x0B 0x00 0x01 0xF5 0xC8
+// Read power request:       0x01 0x04 0x00 0x0C 0x00 0x02 0xB1 0xC8
+// Read power request:       0x01 0x03 0x00 0x0E 0x00 0x01 0xE5 0xC9
+// Read total energy:        0x01 0x03 0x00 0x08 0x00 0x04 0xC5 0xCB
+// Read total energy import: 0x01 0x04 0x00 0x48 0x00 0x02 0xF1 0xDD
+// Read total energy export: 0x01 0x04 0x00 0x4A 0x00 0x02 0x50 0x1D
+static constexpr MeterRegister METER_REGISTERS[] = {
+    {0x0000, 2, METER_REGISTER_FLOAT32, METER_VALUE_VOLTAGE},
+    {0x0002, 4, METER_REGISTER_RESERVED, METER_VALUE_NONE},
+    {0x0006, 2, METER_REGISTER_FLOAT32, METER_VALUE_CURRENT},
+    // Total energy is read as four registers together with the handshake register (0x0B)
+    {0x0008, 2, METER_REGISTER_FLOAT32, METER_VALUE_ENERGY_IMPORT},
+    {0x000A, 2, METER_REGISTER_RESERVED, METER_VALUE_NONE},
+    {REGISTER_POWER_32BIT_FLOAT, 2, METER_REGISTER_FLOAT32, METER_VALUE_POWER},
+    {REGISTER_POWER_16BIT_SINT, 1, METER_REGISTER_INT16, METER_VALUE_POWER},
+    {0x000F, 3, METER_REGISTER_RESERVED, METER_VALUE_NONE},
+    {0x0012, 2, METER_REGISTER_FLOAT32, METER_VALUE_APPARENT_POWER},
+    {0x0014, 10, METER_REGISTER_RESERVED, METER_VALUE_NONE},
+    {0x001E, 2, METER_REGISTER_FLOAT32, METER_VALUE_POWER_FACTOR},
+    {0x0020, 38, METER_REGISTER_RESERVED, METER_VALUE_NONE},
+    {0x0046, 2, METER_REGISTER_FLOAT32, METER_VALUE_FREQUENCY},
+    {0x0048, 2, METER_REGISTER_FLOAT32, METER_VALUE_ENERGY_IMPORT},
+    {0x004A, 2, METER_REGISTER_FLOAT32, METER_VALUE_ENERGY_EXPORT},
+    {0x0156, 2, METER_REGISTER_FLOAT32, METER_VALUE_TOTAL_ENERGY},
+};
+static_assert(solax_meter_modbus::meter_registers_valid(METER_REGISTERS), "Meter registers must be sorted");
+
+SolaxMeterGateway::SolaxMeterGateway() { this->register_map_.set_registers(METER_REGISTERS); }
+
+void SolaxMeterGateway::on_solax_meter_modbus_data(const uint8_t *data, size_t len) {
+  this->last_solax_request_received_ = millis();
+
+  // Decide on the reply before anything is published
+  bool meter_fault = this->inactivity_timeout_();
+  bool power_off = !meter_fault && this->emergency_power_off_switch_ != nullptr &&
+                   this->emergency_power_off_switch_->state;
+  bool manual_mode = this->manual_mode_switch_ != nullptr && this->manual_mode_switch_->state;
+  if (!meter_fault && !power_off && manual_mode) {
+    if (this->manual_power_demand_number_ != nullptr && this->manual_power_demand_number_->has_state()) {
+      this->power_demand_ = this->manual_power_demand_number_->state;
+    } else {
+      this->power_demand_ = 0.0f;
+    }
+  }
+
+  const char *operation_mode = this->regulation_ ? "Auto regulated" : "Auto";
+  if (meter_fault) {
+    operation_mode = "Meter fault";
+  } else if (power_off) {
+    operation_mode = "Off";
+  } else if (manual_mode) {
+    operation_mode = "Manual";
+  }
+
+  uint16_t register_address = (uint16_t(data[1]) << 8) | data[2];
+  uint16_t register_count = (uint16_t(data[3]) << 8) | data[4];
+  bool power_request =
+      register_address <= REGISTER_POWER_16BIT_SINT && register_address + register_count > REGISTER_POWER_32BIT_FLOAT;
+
+  // Run the filter and the controller only if the inverter asks for the power. The bus task replies
+  // before the request gets here, it runs them as soon as a power sample arrives instead
+  if (meter_fault || power_off || manual_mode) {
+    // The power sensor is ignored, there is no measured power to count
+    this->energy_counter_.interrupt();
+    this->power_demand_controller_.reset();
+  } else if (power_request) {
+    if (this->power_poll_callback_) {
+      this->power_poll_callback_();
+    }
+    if (!this->reply_sent_) {
+      this->update_power_demand_(millis());
+    }
+  }
+
+  size_t reply_len = 0;
+  if (!meter_fault && !power_off) {
+    this->update_register_values_();
+    reply_len = this->response_cache_.encode_reply(this->register_map_, this->reply_, this->address_, data);
+  }
+
+  // The low latency mode publishes and logs nothing until the reply left the UART
+  if (!this->low_latency_reply_) {
+    this->publish_state_(this->operation_mode_text_sensor_, operation_mode);
+  }
+
+  if (this->reply_sent_) {
+    // The bus task replied from the last published snapshot
+    this->publish_state_(this->turnaround_time_sensor_, this->reply_sent_us_ - this->request_received_us_);
+  } else if (reply_len > 0) {
+    this->send_frame(this->reply_, reply_len);
+    this->publish_turnaround_time_();
+  }
+
+  if (this->low_latency_reply_) {
+    this->publish_state_(this->operation_mode_text_sensor_, operation_mode);
+  }
+
+  // Hand the switch states and the manual power demand over to the bus task
+  if (this->is_bus_task_()) {
+    this->publish_reply_snapshot_();
+  }
+
+  if (meter_fault) {
     this->publish_state_(power_demand_sensor_, NAN);
     ESP_LOGW(TAG, "No power sensor update received since %d seconds. Triggering meter fault for safety reasons",
              this->power_sensor_inactivity_timeout_s_);
     return;
   }
 
-  if (this->emergency_power_off_switch_ != nullptr && this->emergency_power_off_switch_->state) {
-    this->publish_state_(this->operation_mode_text_sensor_, "Off");
+  if (power_off) {
     this->publish_state_(power_demand_sensor_, 0.0f);
     return;
   }
 
-  if (this->manual_mode_switch_ != nullptr && this->manual_mode_switch_->state) {
-    this->publish_state_(this->operation_mode_text_sensor_, "Manual");
-    if (this->manual_power_demand_number_ != nullptr && this->manual_power_demand_number_->has_state()) {
-      this->power_demand_ = this->manual_power_demand_number_->state;
-    } else {
-      this->power_demand_ = 0.0f;
+  // Exception response
+  if (this->reply_[1] & 0x80) {
+    ESP_LOGW(TAG, "Unhandled register address (0x%02X) with length (%d) requested.", register_address,
+             register_count);
+    ESP_LOGW(TAG, "Your device is probably not supported. Please create an issue here: "
+                  "https://github.com/syssi/esphome-solax-x1-mini/issues");
+    ESP_LOGW(TAG, "Please provide the following request data: %s",
+             format_hex_pretty(data, len).c_str());  // NOLINT
+    return;
+  }
+
+  if (power_request) {
+    this->publish_state_(power_demand_sensor_, this->power_demand_);
+
+    uint32_t now = millis();
+    // Count the measured power, in regulated mode the power demand is the controller output
+    if (!manual_mode && !std::isnan(this->filtered_power_)) {
+      this->energy_counter_.add_sample(this->filtered_power_, now);
+    }
+    if (this->energy_counter_.is_save_due(now)) {
+      this->save_energy_counters_(now);
     }
-  } else {
-    this->publish_state_(this->operation_mode_text_sensor_, "Auto");
-  }
-
-  uint8_t register_address = data[2];
-  switch (register_address) {
-    case REGISTER_HANDSHAKE:
-      // Request: 0x01 0x03 0x00 0x0B 0x00 0x01 0xF5 0xC8
-      //          addr func      reg       bytes*2
-      this->send_raw({0x01, 0x03, 0x02, 0x00, 0x00});
-      break;
-
-    case REGISTER_READ_POWER_32BIT_FLOAT:
-      // Request: 0x01 0x04 0x00 0x0C 0x00 0x02 0xB1 0xC8
-      //          addr func      reg       bytes*2
-      // this->send_raw({0x01, 0x04, 0x04, 0x45, 0x8e, 0x3c, 0x35});  // -4551.52W
-      this->send(this->power_demand_);
-      this->publish_state_(power_demand_sensor_, this->power_demand_);
-      break;
-    case REGISTER_READ_TOTAL_ENERGY_IMPORT_32BIT_FLOAT:
-    case REGISTER_READ_TOTAL_ENERGY_EXPORT_32BIT_FLOAT:
-      // Request: 0x01 0x04 0x00 0x48 0x00 0x02 0xF1 0xDD
-      //          addr func      reg       bytes*2
-
-      // Request: 0x01 0x04 0x00 0x4A 0x00 0x02 0x50 0x1D
-      //          addr func      reg       bytes*2
-      this->send_raw({0x01, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00});
-      break;
-
-    case REGISTER_READ_POWER_16BIT_SINT:
-      // Request: 0x01 0x03 0x00 0x0E 0x00 0x01 0xE5 0xC9
-      //          addr func      reg       bytes*2
-      // this->send_raw({0x01, 0x03, 0x02, 0x00, 0x00});
-      this->send((int16_t) this->power_demand_);
-      this->publish_state_(power_demand_sensor_, this->power_demand_);
-      break;
-    case REGISTER_READ_TOTAL_ENERGY:
-      // Request: 0x01 0x03 0x00 0x08 0x00 0x04 0xC5 0xCB
-      //          addr func      reg       bytes*2
-      this->send_raw({0x01, 0x03, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
-      break;
-
-    default:
-      ESP_LOGW(TAG, "Unhandled register address (0x%02X) with length (%d) requested.", register_address, data[4]);
-      ESP_LOGW(TAG, "Your device is probably not supported. Please create an issue here: "
-                    "https://github.com/syssi/esphome-solax-x1-mini/issues");
-      ESP_LOGW(TAG, "Please provide the following request data: %s",
-               format_hex_pretty(&data.front(), data.size()).c_str());  // NOLINT
   }
+  ESP_LOGV(TAG, "Reply to register 0x%02X: %s", register_address,
+           format_hex_pretty(this->reply_, reply_len).c_str());  // NOLINT
+}
+
+size_t SolaxMeterGateway::encode_reply(const uint8_t *request, uint8_t *buffer) {
+  // Runs in the bus task: copies the last published snapshot and tries again if the main loop
+  // published another one in the meantime
+  uint32_t seq;
+  do {
+    seq = this->reply_snapshot_seq_.load(std::memory_order_acquire);
+    this->task_snapshot_ = this->reply_snapshots_[seq & 1];
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while (this->reply_snapshot_seq_.load(std::memory_order_relaxed) != seq);
+
+  if (!this->task_snapshot_.reply) {
+    return 0;
+  }
+
+  return this->task_response_cache_.encode_reply(this->task_snapshot_.register_map, buffer, this->address_, request);
+}
+
+void SolaxMeterGateway::publish_reply_snapshot_() {
+  bool meter_fault = this->inactivity_timeout_();
+  bool power_off = !meter_fault && this->emergency_power_off_switch_ != nullptr &&
+                   this->emergency_power_off_switch_->state;
+  if (!meter_fault && !power_off) {
+    this->update_register_values_();
+  }
+
+  // Written into the buffer the bus task isn't supposed to read. The fence keeps these writes
+  // behind the previous sequence number, so a bus task still copying this buffer notices
+  uint32_t seq = this->reply_snapshot_seq_.load(std::memory_order_relaxed) + 1;
+  std::atomic_thread_fence(std::memory_order_release);
+  MeterReplySnapshot &snapshot = this->reply_snapshots_[seq & 1];
+  snapshot.register_map = this->register_map_;
+  snapshot.reply = !meter_fault && !power_off;
+  this->reply_snapshot_seq_.store(seq, std::memory_order_release);
+}
+
+void SolaxMeterGateway::update_register_values_() {
+  float power = this->power_demand_;
+  this->register_map_.set_value(METER_VALUE_VOLTAGE, NOMINAL_VOLTAGE);
+  this->register_map_.set_value(METER_VALUE_CURRENT, fabsf(power) / NOMINAL_VOLTAGE);
+  this->register_map_.set_value(METER_VALUE_POWER, power);
+  this->register_map_.set_value(METER_VALUE_APPARENT_POWER, fabsf(power));
+  this->register_map_.set_value(METER_VALUE_POWER_FACTOR, 1.0f);
+  this->register_map_.set_value(METER_VALUE_FREQUENCY, NOMINAL_FREQUENCY);
+  this->register_map_.set_value(METER_VALUE_ENERGY_IMPORT, this->energy_counter_.get_import_kwh());
+  this->register_map_.set_value(METER_VALUE_ENERGY_EXPORT, this->energy_counter_.get_export_kwh());
+  this->register_map_.set_value(METER_VALUE_TOTAL_ENERGY,
+                                this->energy_counter_.get_import_kwh() + this->energy_counter_.get_export_kwh());
+}
+
+void SolaxMeterGateway::publish_turnaround_time_() {
+  this->publish_state_(this->turnaround_time_sensor_, micros() - this->request_received_us_);
+}
+
+void SolaxMeterGateway::update_power_demand_(uint32_t now) {
+  float power = this->measured_power_;
+  if (this->power_demand_source_) {
+    power = this->power_demand_source_();
+  } else if (this->power_demand_filter_.get_type() != FILTER_NONE) {
+    power = this->power_demand_filter_.evaluate(now);
+  }
+  if (std::isnan(power)) {
+    return;
+  }
+  this->filtered_power_ = power;
+
+  // The measured power is the grid power in regulated mode and the power demand otherwise
+  if (this->regulation_) {
+    power = this->power_demand_controller_.update(power, now);
+  }
+  this->power_demand_ = power;
+}
+
+void SolaxMeterGateway::save_energy_counters_(uint32_t now) {
+  EnergyCounterState state = this->energy_counter_.get_state();
+  this->energy_pref_.save(&state);
+  this->energy_counter_.mark_saved(now);
+  ESP_LOGD(TAG, "Energy counters saved (import %.3f kWh, export %.3f kWh)", this->energy_counter_.get_import_kwh(),
+           this->energy_counter_.get_export_kwh());
 }
 
 void SolaxMeterGateway::setup() {
+  this->energy_pref_ = global_preferences->make_preference<EnergyCounterState>(this->energy_hash_);
+  EnergyCounterState state;
+  if (this->energy_pref_.load(&state)) {
+    this->energy_counter_.restore(state);
+  }
+  this->energy_counter_.mark_saved(millis());
+
   this->power_sensor_->add_on_state_callback([this](float state) {
     if (std::isnan(state)) {
       ESP_LOGVV(TAG, "Invalid power demand received: NaN");
@@ -99,25 +271,61 @@ void SolaxMeterGateway::setup() {
       return;
     }
 
-    this->power_demand_ = state;
     this->last_power_demand_received_ = millis();
-    ESP_LOGVV(TAG, "New power demand received (%.2f). Resetting inactivity timeout (%lu)", this->power_demand_,
+    ESP_LOGVV(TAG, "New power demand received (%.2f). Resetting inactivity timeout (%lu)", state,
               (unsigned long) this->last_power_demand_received_);
+
+    // The filter and the controller are evaluated when the inverter polls the power
+    if (this->power_demand_filter_.get_type() != FILTER_NONE) {
+      this->power_demand_filter_.add_sample(state, this->last_power_demand_received_);
+    } else {
+      this->measured_power_ = state;
+    }
+
+    // The bus task replies to the next power poll on its own, so it gets the new power demand right away
+    if (this->is_bus_task_()) {
+      this->update_power_demand_(this->last_power_demand_received_);
+      this->publish_reply_snapshot_();
+    }
   });
 }
 
+void SolaxMeterGateway::on_shutdown() {
+  // Don't lose the energy since the last save on a planned reboot
+  if (this->energy_counter_.has_unsaved_changes()) {
+    this->save_energy_counters_(millis());
+  }
+}
+
 void SolaxMeterGateway::dump_config() {
   ESP_LOGCONFIG(TAG, "SolaxMeterGateway:");
   ESP_LOGCONFIG(TAG, "  Address: 0x%02X", this->address_);
+  ESP_LOGCONFIG(TAG, "  Low latency reply: %s", YESNO(this->low_latency_reply_));
+  ESP_LOGCONFIG(TAG, "  Power demand filter: %u", this->power_demand_filter_.get_type());
+  if (this->power_demand_source_ && this->power_demand_filter_.get_type() != FILTER_NONE) {
+    ESP_LOGW(TAG, "  The power demand filter isn't applied to the share of the coordinator");
+  }
+  ESP_LOGCONFIG(TAG, "  Power demand regulation: %s", YESNO(this->regulation_));
   LOG_SENSOR("  ", "Power Demand", this->power_demand_sensor_);
+  LOG_SENSOR("  ", "Turnaround Time", this->turnaround_time_sensor_);
+  LOG_SENSOR("  ", "Energy Import", this->energy_import_sensor_);
+  LOG_SENSOR("  ", "Energy Export", this->energy_export_sensor_);
   LOG_TEXT_SENSOR("  ", "Operation name", this->operation_mode_text_sensor_);
 }
 
 void SolaxMeterGateway::update() {
+  this->publish_state_(this->energy_import_sensor_, this->energy_counter_.get_import_kwh());
+  this->publish_state_(this->energy_export_sensor_, this->energy_counter_.get_export_kwh());
+
   if (millis() - this->last_solax_request_received_ > (this->solax_request_inactivity_timeout_s_ * 1000)) {
     this->publish_state_(this->operation_mode_text_sensor_, "Standby");
     ESP_LOGI(TAG, "No solax request received. Is the inverter online and export control mode 'meter' enabled?");
   }
+
+  // Stops the replies of the bus task on a meter fault, even if no power sample arrives anymore
+  if (this->is_bus_task_()) {
+    this->publish_reply_snapshot_();
+  }
 }
 
 bool SolaxMeterGateway::inactivity_timeout_() {
@@ -1,26 +1,78 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/number/number.h"
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/switch/switch.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 #include "esphome/components/solax_meter_modbus/solax_meter_modbus.h"
+#include "energy_counter.h"
+#include "power_demand_controller.h"
+#include "power_demand_filter.h"
+
+#include <atomic>
+#include <functional>
 
 namespace esphome::solax_meter_gateway {
 
+// What the bus task replies with. Published by the main loop, never modified once the bus task may read it
+struct MeterReplySnapshot {
+  solax_meter_modbus::SolaxMeterRegisterMap register_map;
+  // False on a meter fault or an emergency power off
+  bool reply{false};
+};
+
 class SolaxMeterGateway : public PollingComponent, public solax_meter_modbus::SolaxMeterModbusDevice {
  public:
+  SolaxMeterGateway();
+
   void set_manual_power_demand_number(number::Number *manual_power_demand_number) {
     manual_power_demand_number_ = manual_power_demand_number;
   }
 
   void set_power_sensor(sensor::Sensor *power_sensor) { power_sensor_ = power_sensor; }
   void set_power_demand_sensor(sensor::Sensor *power_demand_sensor) { power_demand_sensor_ = power_demand_sensor; }
+  void set_turnaround_time_sensor(sensor::Sensor *turnaround_time_sensor) {
+    turnaround_time_sensor_ = turnaround_time_sensor;
+  }
+  void set_energy_import_sensor(sensor::Sensor *energy_import_sensor) { energy_import_sensor_ = energy_import_sensor; }
+  void set_energy_export_sensor(sensor::Sensor *energy_export_sensor) { energy_export_sensor_ = energy_export_sensor; }
   void set_power_sensor_inactivity_timeout(uint16_t power_sensor_inactivity_timeout_s) {
     this->power_sensor_inactivity_timeout_s_ = power_sensor_inactivity_timeout_s;
   }
 
+  void set_low_latency_reply(bool low_latency_reply) { this->low_latency_reply_ = low_latency_reply; }
+  void set_energy_save_interval(uint32_t energy_save_interval) {
+    this->energy_counter_.set_save_interval(energy_save_interval);
+  }
+  // Keeps the energy counters of gateways at the same address on different UARTs apart
+  void set_energy_key(const std::string &key) { this->energy_hash_ = fnv1_hash("solax_meter_gateway_energy_" + key); }
+  void set_power_demand_filter(PowerDemandFilterType type, float alpha, uint8_t window_size,
+                               uint32_t max_extrapolation) {
+    this->power_demand_filter_.set_type(type);
+    this->power_demand_filter_.set_alpha(alpha);
+    this->power_demand_filter_.set_window_size(window_size);
+    this->power_demand_filter_.set_max_extrapolation(max_extrapolation);
+  }
+  void set_power_demand_controller(float setpoint, float kp, float ki, float min_power_demand,
+                                   float max_power_demand) {
+    this->power_demand_controller_.set_setpoint(setpoint);
+    this->power_demand_controller_.set_gains(kp, ki);
+    this->power_demand_controller_.set_limits(min_power_demand, max_power_demand);
+    this->regulation_ = true;
+  }
+
+  // Replaces the power sensor as source of the power demand (e.g. a share computed by a coordinator)
+  void set_power_demand_source(std::function<float()> &&power_demand_source) {
+    this->power_demand_source_ = std::move(power_demand_source);
+  }
+  // Called whenever the inverter polls the power and gets a reply. The power demand source may be
+  // queried at any time, e.g. on every power sample in bus task mode
+  void set_power_poll_callback(std::function<void()> &&power_poll_callback) {
+    this->power_poll_callback_ = std::move(power_poll_callback);
+  }
+
   void set_manual_mode_switch(switch_::Switch *manual_mode_switch) { manual_mode_switch_ = manual_mode_switch; }
   void set_emergency_power_off_switch(switch_::Switch *emergency_power_off_switch) {
     emergency_power_off_switch_ = emergency_power_off_switch;
@@ -32,12 +84,15 @@ class SolaxMeterGateway : public PollingComponent, public solax_meter_modbus::So
 
   void setup() override;
 
-  void on_solax_meter_modbus_data(const std::vector<uint8_t> &data) override;
+  void on_solax_meter_modbus_data(const uint8_t *data, size_t len) override;
+  size_t encode_reply(const uint8_t *request, uint8_t *buffer) override;
 
   void dump_config() override;
 
   void update() override;
 
+  void on_shutdown() override;
+
   float get_setup_priority() const override { return setup_priority::DATA; }
 
  protected:
@@ -45,6 +100,9 @@ class SolaxMeterGateway : public PollingComponent, public solax_meter_modbus::So
 
   sensor::Sensor *power_sensor_{nullptr};
   sensor::Sensor *power_demand_sensor_{nullptr};
+  sensor::Sensor *turnaround_time_sensor_{nullptr};
+  sensor::Sensor *energy_import_sensor_{nullptr};
+  sensor::Sensor *energy_export_sensor_{nullptr};
 
   switch_::Switch *manual_mode_switch_{nullptr};
   switch_::Switch *emergency_power_off_switch_{nullptr};
@@ -52,14 +110,41 @@ class SolaxMeterGateway : public PollingComponent, public solax_meter_modbus::So
   text_sensor::TextSensor *operation_mode_text_sensor_{nullptr};
 
   float power_demand_;
+  float measured_power_{NAN};
+  // Measured power after the filter and before the controller, integrated by the energy counter
+  float filtered_power_{NAN};
   uint16_t power_sensor_inactivity_timeout_s_{0};
   uint16_t solax_request_inactivity_timeout_s_{10};
   uint32_t last_power_demand_received_{0};
   uint32_t last_solax_request_received_{0};
+  bool low_latency_reply_{false};
+  solax_meter_modbus::SolaxMeterRegisterMap register_map_;
+  solax_meter_modbus::SolaxMeterResponseCache response_cache_;
+  uint8_t reply_[solax_meter_modbus::METER_MAX_READ_RESPONSE_SIZE];
+  // Double buffer, the bus task reads the snapshot of the last published sequence number
+  MeterReplySnapshot reply_snapshots_[2];
+  std::atomic<uint32_t> reply_snapshot_seq_{0};
+  // Only touched by the bus task
+  MeterReplySnapshot task_snapshot_;
+  solax_meter_modbus::SolaxMeterResponseCache task_response_cache_;
+  PowerDemandFilter power_demand_filter_;
+  PowerDemandController power_demand_controller_;
+  std::function<float()> power_demand_source_;
+  std::function<void()> power_poll_callback_;
+  bool regulation_{false};
+  EnergyCounter energy_counter_;
+  uint32_t energy_hash_{fnv1_hash("solax_meter_gateway_energy")};
+  ESPPreferenceObject energy_pref_;
 
   void publish_state_(sensor::Sensor *sensor, float value);
   void publish_state_(text_sensor::TextSensor *text_sensor, const std::string &state);
   bool inactivity_timeout_();
+  bool is_bus_task_() const { return this->parent_ != nullptr && this->parent_->is_bus_task(); }
+  void publish_reply_snapshot_();
+  void update_register_values_();
+  void publish_turnaround_time_();
+  void update_power_demand_(uint32_t now);
+  void save_energy_counters_(uint32_t now);
 };
 
 }  // namespace esphome::solax_meter_gateway
@@ -2,14 +2,26 @@ from esphome import pins
 import esphome.codegen as cg
 from esphome.components import uart
 import esphome.config_validation as cv
-from esphome.const import CONF_ADDRESS, CONF_FLOW_CONTROL_PIN, CONF_ID
+from esphome.const import (
+    CONF_ADDRESS,
+    CONF_FLOW_CONTROL_PIN,
+    CONF_ID,
+    CONF_NUMBER,
+    CONF_RX_PIN,
+    CONF_UART_ID,
+)
+from esphome.core import CORE
 from esphome.cpp_helpers import gpio_pin_expression
+import esphome.final_validate as fv
 
 DEPENDENCIES = ["uart"]
 CODEOWNERS = ["@syssi"]
 MULTI_CONF = True
 
 CONF_SOLAX_METER_MODBUS_ID = "solax_meter_modbus_id"
+CONF_NON_BLOCKING_TRANSMIT = "non_blocking_transmit"
+CONF_BUS_TASK = "bus_task"
+CONF_RX_WAKEUP_PIN = "rx_wakeup_pin"
 
 solax_meter_modbus_ns = cg.esphome_ns.namespace("solax_meter_modbus")
 SolaxMeterModbus = solax_meter_modbus_ns.class_(
@@ -17,11 +29,49 @@ SolaxMeterModbus = solax_meter_modbus_ns.class_(
 )
 SolaxMeterModbusDevice = solax_meter_modbus_ns.class_("SolaxMeterModbusDevice")
 
+
+def validate_bus_task(value):
+    value = cv.boolean(value)
+    if value:
+        # The bus task is a FreeRTOS task pinned to a core
+        cv.only_on_esp32(value)
+    return value
+
+
+# RX pins of the ESP8266 hardware UART (GPIO13 if swapped),
+# any other RX pin is read by the software serial
+ESP8266_HARDWARE_UART_RX_PINS = [3, 13]
+
+
+def validate_rx_wakeup_uart(uart_config):
+    # The software serial of the ESP8266 receives from the interrupt of the RX pin,
+    # the wakeup interrupt would replace it
+    rx_pin = uart_config.get(CONF_RX_PIN)
+    if rx_pin is None or rx_pin[CONF_NUMBER] not in ESP8266_HARDWARE_UART_RX_PINS:
+        raise cv.Invalid(
+            f"{CONF_RX_WAKEUP_PIN} requires the hardware UART on the ESP8266 "
+            "(rx_pin GPIO3 or GPIO13)"
+        )
+    return uart_config
+
+
+def final_validate_rx_wakeup_pin(config):
+    if CONF_RX_WAKEUP_PIN in config and CORE.is_esp8266:
+        fv.id_declaration_match_schema(validate_rx_wakeup_uart)(config[CONF_UART_ID])
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate_rx_wakeup_pin
+
+
 CONFIG_SCHEMA = (
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(SolaxMeterModbus),
             cv.Optional(CONF_FLOW_CONTROL_PIN): pins.gpio_output_pin_schema,
+            cv.Optional(CONF_NON_BLOCKING_TRANSMIT, default=False): cv.boolean,
+            cv.Optional(CONF_BUS_TASK, default=False): validate_bus_task,
+            cv.Optional(CONF_RX_WAKEUP_PIN): pins.internal_gpio_input_pin_schema,
         }
     )
     .extend(cv.COMPONENT_SCHEMA)
@@ -40,6 +90,13 @@ async def to_code(config):
         pin = await gpio_pin_expression(config[CONF_FLOW_CONTROL_PIN])
         cg.add(var.set_flow_control_pin(pin))
 
+    cg.add(var.set_non_blocking_transmit(config[CONF_NON_BLOCKING_TRANSMIT]))
+    cg.add(var.set_bus_task(config[CONF_BUS_TASK]))
+
+    if CONF_RX_WAKEUP_PIN in config:
+        pin = await gpio_pin_expression(config[CONF_RX_WAKEUP_PIN])
+        cg.add(var.set_rx_wakeup_pin(pin))
+
 
 def solax_meter_modbus_device_schema(default_address):
     schema = {
@@ -2,6 +2,10 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace esphome::solax_meter_modbus {
 
 static const char *const TAG = "solax_meter_modbus";
@@ -10,30 +14,113 @@ void SolaxMeterModbus::setup() {
   if (this->flow_control_pin_ != nullptr) {
     this->flow_control_pin_->setup();
   }
+
+  if (this->rx_wakeup_pin_ != nullptr) {
+    // The pin is owned by the UART, only listen to its edges
+    this->rx_wakeup_pin_->attach_interrupt(SolaxMeterModbus::gpio_intr, this, gpio::INTERRUPT_FALLING_EDGE);
+  }
+
+#ifdef USE_ESP32
+  if (this->bus_task_) {
+    // Above the priority of the main loop and pinned to the core the main loop runs on, away from Wi-Fi
+    xTaskCreatePinnedToCore(SolaxMeterModbus::bus_task, "solax_meter_bus", 4096, this, 5, &this->bus_task_handle_,
+                            portNUM_PROCESSORS - 1);
+  }
+#endif
 }
+
+#ifdef USE_ESP32
+void SolaxMeterModbus::bus_task(void *param) {
+  auto *bus = static_cast<SolaxMeterModbus *>(param);
+  while (true) {
+    bus->read_rx_();
+    vTaskDelay(1);
+  }
+}
+#endif
+
 void SolaxMeterModbus::loop() {
+  this->check_transmit_(micros());
+
+  // The bus task reads and answers the requests, the main loop only dispatches them
+  if (this->bus_task_) {
+    this->process_requests_();
+    return;
+  }
+
+  this->read_rx_();
+
+  // Nothing to do until the next edge on the RX pin wakes the loop up again
+  if (this->rx_wakeup_ && !this->rx_active_ && !this->transmitting_)
+    this->disable_loop();
+}
+
+void IRAM_ATTR SolaxMeterModbus::gpio_intr(SolaxMeterModbus *arg) {
+  arg->rx_event_ = true;
+  arg->enable_loop_soon_any_context();
+}
+
+bool SolaxMeterModbus::rx_pending_(uint32_t now) {
+  if (!this->rx_wakeup_)
+    return true;
+
+  if (this->rx_event_) {
+    this->rx_event_ = false;
+    this->rx_active_ = true;
+    this->last_rx_event_ = now;
+  } else if (this->rx_active_ && this->rx_buffer_len_ == 0 && now - this->last_rx_event_ > RX_WAKEUP_HOLD_TIME) {
+    this->rx_active_ = false;
+  }
+
+  return this->rx_active_;
+}
+
+void SolaxMeterModbus::read_rx_() {
   const uint32_t now = millis();
+  // The line is idle, skip the parser entirely
+  if (!this->rx_pending_(now))
+    return;
+
   if (now - this->last_solax_meter_modbus_byte_ > 50) {
-    this->rx_buffer_.clear();
+    this->rx_buffer_len_ = 0;
     this->last_solax_meter_modbus_byte_ = now;
   }
 
-  while (this->available()) {
-    uint8_t byte;
-    this->read_byte(&byte);
-    if (this->parse_solax_meter_modbus_byte_(byte)) {
-      this->last_solax_meter_modbus_byte_ = now;
-    } else {
-      this->rx_buffer_.clear();
-    }
+  // Drain everything available with a single read per buffer fill instead of a read_byte() per byte
+  size_t available = this->available();
+  while (available > 0) {
+    size_t len = std::min(available, sizeof(this->rx_buffer_) - this->rx_buffer_len_);
+    if (!this->read_array(this->rx_buffer_ + this->rx_buffer_len_, len))
+      break;
+    this->request_received_us_ = micros();
+    this->rx_buffer_len_ += len;
+    available -= len;
+
+    this->parse_rx_buffer_();
+    this->last_solax_meter_modbus_byte_ = now;
+  }
+}
+
+void SolaxMeterModbus::process_requests_() {
+  MeterRequest request;
+  while (this->requests_.pop(&request)) {
+    this->dispatch_request_(request);
+  }
+
+  // The bus task doesn't log, report its drops from here
+  uint32_t dropped = this->requests_.get_dropped();
+  if (dropped != this->requests_dropped_logged_) {
+    ESP_LOGW(TAG, "Request queue full. %u requests dropped", (unsigned) (dropped - this->requests_dropped_logged_));
+    this->requests_dropped_logged_ = dropped;
   }
 }
 
 bool SolaxMeterModbus::parse_solax_meter_modbus_byte_(uint8_t byte) {
-  size_t at = this->rx_buffer_.size();
-  this->rx_buffer_.push_back(byte);
-  const uint8_t *raw = &this->rx_buffer_[0];
+  this->rx_buffer_[this->rx_buffer_len_++] = byte;
+  return this->parse_rx_buffer_();
+}
 
+bool SolaxMeterModbus::parse_rx_buffer_() {
   // Meter requests of a Solax X1 mini 600W
   //
   // Handshake request:        0x01 0x03 0x00 0x0B 0x00 0x01 0xF5 0xC8
@@ -49,51 +136,161 @@ bool SolaxMeterModbus::parse_solax_meter_modbus_byte_(uint8_t byte) {
   // Read total energy:        0x01 0x03 0x00 0x08 0x00 0x04 0xC5 0xCB
   //                           addr func      reg       len  crc  crc
 
-  if (at == 0)
-    return true;
-  uint8_t address = raw[0];
+  size_t pos = 0;
+  while (this->rx_buffer_len_ - pos >= METER_REQUEST_SIZE) {
+    if (this->parse_solax_meter_modbus_frame_(this->rx_buffer_ + pos)) {
+      pos += METER_REQUEST_SIZE;
+      continue;
+    }
 
-  if (at == 2)
-    return true;
+    // Skip to the next plausible request instead of dropping everything buffered
+    size_t next = this->find_frame_start_(pos + 1);
+    if (!this->bus_task_)
+      ESP_LOGD(TAG, "Resynchronizing. %zu bytes discarded", next - pos);
+    this->resync_count_++;
+    this->discarded_bytes_ += next - pos;
+    pos = next;
+  }
 
-  uint8_t data_len = 5;
-  uint8_t data_offset = 1;
+  // Keep the incomplete request at the front of the buffer
+  if (pos > 0) {
+    this->rx_buffer_len_ -= pos;
+    memmove(this->rx_buffer_, this->rx_buffer_ + pos, this->rx_buffer_len_);
+  }
 
-  if (at < data_offset + data_len)
-    return true;
+  return this->rx_buffer_len_ > 0;
+}
 
-  if (at == data_offset + data_len)
-    return true;
+size_t SolaxMeterModbus::find_frame_start_(size_t from) const {
+  for (size_t i = from; i < this->rx_buffer_len_; i++) {
+    // Modbus RTU slave address (1...247) followed by a read function code
+    uint8_t address = this->rx_buffer_[i];
+    if (address == 0 || address > 247)
+      continue;
+    if (i + 1 == this->rx_buffer_len_)
+      return i;
+    uint8_t function = this->rx_buffer_[i + 1];
+    if (function == 0x03 || function == 0x04)
+      return i;
+  }
+  return this->rx_buffer_len_;
+}
 
-  ESP_LOGVV(TAG, "RX <- %s", format_hex_pretty(raw, at + 1).c_str());  // NOLINT
+bool SolaxMeterModbus::parse_solax_meter_modbus_frame_(const uint8_t *raw) {
+  ESP_LOGVV(TAG, "RX <- %s", format_hex_pretty(raw, METER_REQUEST_SIZE).c_str());  // NOLINT
+
+  uint8_t data_len = 5;
+  uint8_t data_offset = 1;
 
   uint16_t computed_crc = crc16(raw, data_offset + data_len);
   uint16_t remote_crc = uint16_t(raw[data_offset + data_len]) | (uint16_t(raw[data_offset + data_len + 1]) << 8);
   if (computed_crc != remote_crc) {
-    ESP_LOGW(TAG, "CRC check failed! 0x%04X != 0x%04X", computed_crc, remote_crc);
+    // The bus task only counts the resync
+    if (!this->bus_task_)
+      ESP_LOGW(TAG, "CRC check failed! 0x%04X != 0x%04X", computed_crc, remote_crc);
     return false;
   }
 
-  std::vector<uint8_t> data(this->rx_buffer_.begin() + data_offset, this->rx_buffer_.begin() + data_offset + data_len);
-  bool found = false;
-  for (auto *device : this->devices_) {
-    if (device->address_ == address) {
-      device->on_solax_meter_modbus_data(data);
-      found = true;
-    }
+  MeterRequest request;
+  memcpy(request.frame, raw, METER_REQUEST_SIZE);
+  request.received_us = this->request_received_us_;
+  request.replied = false;
+  request.replied_us = 0;
+
+  if (!this->bus_task_) {
+    this->dispatch_request_(request);
+    return true;
   }
 
-  if (!found) {
-    ESP_LOGW(TAG, "Got SolaxMeterModbus frame from unknown address 0x%02X! ", address);
+  // Reply right away from the bus task and leave everything else to the main loop
+  request.replied = this->reply_from_bus_task_(raw);
+  request.replied_us = micros();
+  // The main loop reports the dropped requests
+  this->requests_.push(request);
+  return true;
+}
+
+bool SolaxMeterModbus::reply_from_bus_task_(const uint8_t *raw) {
+  SolaxMeterModbusDevice *device = this->devices_by_address_[raw[0]];
+  if (device == nullptr)
+    return false;
+
+  size_t len = device->encode_reply(raw + 1, this->task_reply_);
+  if (len == 0)
+    return false;
+
+  this->send_frame(this->task_reply_, len);
+  return true;
+}
+
+void SolaxMeterModbus::dispatch_request_(const MeterRequest &request) {
+  uint8_t address = request.frame[0];
+  SolaxMeterModbusDevice *device = this->devices_by_address_[address];
+  if (device == nullptr) {
+    this->log_unknown_address_(address, millis());
+    return;
+  }
+
+  device->request_received_us_ = request.received_us;
+  device->reply_sent_ = request.replied;
+  device->reply_sent_us_ = request.replied_us;
+  // Function code, register and register count, without the address and the CRC
+  device->on_solax_meter_modbus_data(request.frame + 1, METER_REQUEST_SIZE - 3);
+}
+
+void SolaxMeterModbus::log_unknown_address_(uint8_t address, uint32_t now) {
+  this->unknown_addresses_++;
+
+  // Requests to other slaves on a shared bus show up with every poll
+  if (this->unknown_addresses_logged_ > 0 && now - this->last_unknown_address_log_ < UNKNOWN_ADDRESS_LOG_INTERVAL)
+    return;
+
+  ESP_LOGW(TAG, "Got SolaxMeterModbus frame from unknown address 0x%02X! %u such frames since last warning", address,
+           (unsigned) (this->unknown_addresses_ - this->unknown_addresses_logged_));
+  this->unknown_addresses_logged_ = this->unknown_addresses_;
+  this->last_unknown_address_log_ = now;
+}
+
+void SolaxMeterModbus::register_device(SolaxMeterModbusDevice *device) {
+  this->devices_.push_back(device);
+  if (this->devices_by_address_[device->address_] == nullptr)
+    this->devices_by_address_[device->address_] = device;
+}
+
+bool MeterRequestQueue::push(const MeterRequest &request) {
+  uint8_t tail = this->tail_.load(std::memory_order_relaxed);
+  uint8_t next = (tail + 1) % METER_REQUEST_QUEUE_SIZE;
+  if (next == this->head_.load(std::memory_order_acquire)) {
+    this->dropped_++;
+    return false;
   }
 
-  // return false to reset buffer
-  return false;
+  this->items_[tail] = request;
+  this->tail_.store(next, std::memory_order_release);
+  return true;
+}
+
+bool MeterRequestQueue::pop(MeterRequest *request) {
+  uint8_t head = this->head_.load(std::memory_order_relaxed);
+  if (head == this->tail_.load(std::memory_order_acquire))
+    return false;
+
+  *request = this->items_[head];
+  this->head_.store((head + 1) % METER_REQUEST_QUEUE_SIZE, std::memory_order_release);
+  return true;
 }
 
 void SolaxMeterModbus::dump_config() {
   ESP_LOGCONFIG(TAG, "SolaxMeterModbus:");
   LOG_PIN("  Flow Control Pin: ", this->flow_control_pin_);
+  LOG_PIN("  RX Wakeup Pin: ", this->rx_wakeup_pin_);
+  ESP_LOGCONFIG(TAG, "  Non-blocking transmit: %s", YESNO(this->non_blocking_transmit_));
+  ESP_LOGCONFIG(TAG, "  Bus task: %s", YESNO(this->bus_task_));
+  for (auto *device : this->devices_) {
+    if (this->devices_by_address_[device->address_] != device)
+      ESP_LOGW(TAG, "  Address 0x%02X is used by several devices. Only the first one gets the requests",
+               device->address_);
+  }
 
   this->check_uart_settings(9600);
 }
@@ -104,59 +301,25 @@ float SolaxMeterModbus::get_setup_priority() const {
 }
 
 void SolaxMeterModbus::send(uint8_t address, int16_t power) {
-  std::vector<uint8_t> data;
-  data.push_back(address);
-  data.push_back(0x03);
-  data.push_back(0x02);
-  data.push_back(power >> 8);
-  data.push_back(power >> 0);
-  auto crc = crc16(data.data(), data.size());
-  data.push_back(crc >> 0);
-  data.push_back(crc >> 8);
+  const uint8_t payload[2] = {uint8_t(power >> 8), uint8_t(power >> 0)};
+  uint8_t frame[METER_MAX_RESPONSE_SIZE];
+  size_t len = encode_meter_response(frame, address, 0x03, payload, sizeof(payload));
 
-  if (this->flow_control_pin_ != nullptr)
-    this->flow_control_pin_->digital_write(true);
-
-  this->write_array(data);
-  this->flush();
+  this->send_frame(frame, len);
 
-  if (this->flow_control_pin_ != nullptr)
-    this->flow_control_pin_->digital_write(false);
-
-  ESP_LOGV(TAG, "SolaxMeterModbus write: %s", format_hex_pretty(data).c_str());  // NOLINT
+  ESP_LOGV(TAG, "SolaxMeterModbus write: %s", format_hex_pretty(frame, len).c_str());  // NOLINT
 }
 
 void SolaxMeterModbus::send(uint8_t address, float power) {
-  union float_bytes_t {
-    float f;
-    uint8_t i[4];
-  };
-
-  float_bytes_t payload;
-  payload.f = power;
-
-  std::vector<uint8_t> data;
-  data.push_back(address);
-  data.push_back(0x04);
-  data.push_back(0x04);
-  data.push_back(payload.i[3]);
-  data.push_back(payload.i[2]);
-  data.push_back(payload.i[1]);
-  data.push_back(payload.i[0]);
-  auto crc = crc16(data.data(), data.size());
-  data.push_back(crc >> 0);
-  data.push_back(crc >> 8);
-
-  if (this->flow_control_pin_ != nullptr)
-    this->flow_control_pin_->digital_write(true);
+  uint32_t raw;
+  memcpy(&raw, &power, sizeof(raw));
+  const uint8_t payload[4] = {uint8_t(raw >> 24), uint8_t(raw >> 16), uint8_t(raw >> 8), uint8_t(raw >> 0)};
+  uint8_t frame[METER_MAX_RESPONSE_SIZE];
+  size_t len = encode_meter_response(frame, address, 0x04, payload, sizeof(payload));
 
-  this->write_array(data);
-  this->flush();
+  this->send_frame(frame, len);
 
-  if (this->flow_control_pin_ != nullptr)
-    this->flow_control_pin_->digital_write(false);
-
-  ESP_LOGV(TAG, "SolaxMeterModbus write: %s", format_hex_pretty(data).c_str());  // NOLINT
+  ESP_LOGV(TAG, "SolaxMeterModbus write: %s", format_hex_pretty(frame, len).c_str());  // NOLINT
 }
 
 // Helper function for lambdas
@@ -173,11 +336,184 @@ void SolaxMeterModbus::send_raw(const std::vector<uint8_t> &payload) {
   this->write_array(payload);
   this->write_byte(crc & 0xFF);
   this->write_byte((crc >> 8) & 0xFF);
-  this->flush();
+  this->end_transmit_(payload.size() + 2);
+
+  ESP_LOGV(TAG, "SolaxMeterModbus write raw: %s", format_hex_pretty(payload).c_str());  // NOLINT
+}
+
+void SolaxMeterModbus::send_frame(const uint8_t *frame, size_t len) {
+  if (this->flow_control_pin_ != nullptr)
+    this->flow_control_pin_->digital_write(true);
+
+  this->write_array(frame, len);
+  this->end_transmit_(len);
+}
+
+void SolaxMeterModbus::end_transmit_(size_t len) {
+  // The bus task can afford to wait for the UART
+  if (!this->non_blocking_transmit_ || this->bus_task_) {
+    this->flush();
+    if (this->flow_control_pin_ != nullptr)
+      this->flow_control_pin_->digital_write(false);
+    return;
+  }
+
+  // The UART shifts the frame out in the background. The flow control pin is released
+  // by loop() once the last byte left the wire (plus one byte time as guard)
+  uint32_t now = micros();
+  uint32_t duration = this->get_transmit_time_us(len + 1);
+  if (this->transmitting_ && int32_t(this->transmit_end_us_ - now) > 0) {
+    this->transmit_end_us_ += duration;
+  } else {
+    this->transmit_end_us_ = now + duration;
+  }
+  this->transmitting_ = true;
+  this->high_freq_.start();
+}
+
+void SolaxMeterModbus::check_transmit_(uint32_t now_us) {
+  if (!this->transmitting_ || int32_t(now_us - this->transmit_end_us_) < 0)
+    return;
+
   if (this->flow_control_pin_ != nullptr)
     this->flow_control_pin_->digital_write(false);
+  this->transmitting_ = false;
+  this->high_freq_.stop();
+}
 
-  ESP_LOGV(TAG, "SolaxMeterModbus write raw: %s", format_hex_pretty(payload).c_str());  // NOLINT
+uint32_t SolaxMeterModbus::get_transmit_time_us(size_t len) const {
+  uint32_t bits = 1 + this->parent_->get_data_bits() + this->parent_->get_stop_bits() +
+                  (this->parent_->get_parity() != uart::UART_CONFIG_PARITY_NONE ? 1 : 0);
+  return uint64_t(len) * bits * 1000000 / this->parent_->get_baud_rate();
+}
+
+size_t encode_meter_response(uint8_t *buffer, uint8_t address, uint8_t function, const uint8_t *data,
+                             uint8_t data_len) {
+  buffer[0] = address;
+  buffer[1] = function;
+  buffer[2] = data_len;
+  memcpy(buffer + 3, data, data_len);
+  auto crc = crc16(buffer, 3 + data_len);
+  buffer[3 + data_len] = crc >> 0;
+  buffer[4 + data_len] = crc >> 8;
+  return 5 + data_len;
+}
+
+size_t encode_meter_exception(uint8_t *buffer, uint8_t address, uint8_t function, MeterException exception) {
+  buffer[0] = address;
+  buffer[1] = function | 0x80;
+  buffer[2] = exception;
+  auto crc = crc16(buffer, 3);
+  buffer[3] = crc >> 0;
+  buffer[4] = crc >> 8;
+  return METER_EXCEPTION_RESPONSE_SIZE;
+}
+
+size_t SolaxMeterRegisterMap::encode_reply(uint8_t *buffer, uint8_t address, const uint8_t *request,
+                                           uint16_t *values) const {
+  uint8_t function = request[0];
+  uint16_t first = (uint16_t(request[1]) << 8) | request[2];
+  uint16_t count = (uint16_t(request[3]) << 8) | request[4];
+
+  if (function != 0x03 && function != 0x04) {
+    return encode_meter_exception(buffer, address, function, METER_EXCEPTION_ILLEGAL_FUNCTION);
+  }
+  if (count == 0 || count > METER_MAX_READ_REGISTERS) {
+    return encode_meter_exception(buffer, address, function, METER_EXCEPTION_ILLEGAL_DATA_VALUE);
+  }
+
+  // First block which ends behind the first requested register
+  const MeterRegister *end = this->registers_ + this->registers_len_;
+  const MeterRegister *block = std::upper_bound(
+      this->registers_, end, first,
+      [](uint16_t address, const MeterRegister &block) { return address < block.address + block.count; });
+
+  uint32_t last = uint32_t(first) + count;
+  uint8_t *data = buffer + 3;
+  for (uint32_t reg = first; reg < last; block++) {
+    // Every requested register must be mapped
+    if (block == end || block->address > reg) {
+      return encode_meter_exception(buffer, address, function, METER_EXCEPTION_ILLEGAL_DATA_ADDRESS);
+    }
+
+    uint32_t block_end = std::min<uint32_t>(block->address + block->count, last);
+    if (values != nullptr && block->type != METER_REGISTER_RESERVED)
+      *values |= 1 << block->value;
+    for (; reg < block_end; reg++) {
+      uint16_t value = this->read_register_(*block, reg - block->address);
+      *data++ = value >> 8;
+      *data++ = value >> 0;
+    }
+  }
+
+  buffer[0] = address;
+  buffer[1] = function;
+  buffer[2] = count * 2;
+  auto crc = crc16(buffer, 3 + count * 2);
+  buffer[3 + count * 2] = crc >> 0;
+  buffer[4 + count * 2] = crc >> 8;
+  return 5 + count * 2;
+}
+
+bool SolaxMeterRegisterMap::is_unchanged_since(uint16_t values, uint32_t generation) const {
+  for (uint8_t value = 0; values != 0; value++, values >>= 1) {
+    if ((values & 1) && int32_t(this->changed_[value] - generation) > 0)
+      return false;
+  }
+  return true;
+}
+
+uint16_t SolaxMeterRegisterMap::read_register_(const MeterRegister &block, uint16_t offset) const {
+  float value = this->values_[block.value];
+
+  switch (block.type) {
+    case METER_REGISTER_FLOAT32: {
+      uint32_t raw;
+      memcpy(&raw, &value, sizeof(raw));
+      return offset == 0 ? raw >> 16 : raw & 0xFFFF;
+    }
+    case METER_REGISTER_INT16:
+      if (std::isnan(value))
+        return 0;
+      return uint16_t(int16_t(std::max(-32768.0f, std::min(value, 32767.0f))));
+    default:
+      return 0;
+  }
+}
+
+size_t SolaxMeterResponseCache::encode_reply(const SolaxMeterRegisterMap &map, uint8_t *buffer, uint8_t address,
+                                             const uint8_t *request) {
+  Entry *entry = nullptr;
+  for (auto &candidate : this->entries_) {
+    if (candidate.frame.len == 0 || candidate.address != address || memcmp(candidate.request, request, 5) != 0)
+      continue;
+
+    if (map.is_unchanged_since(candidate.values, candidate.generation)) {
+      memcpy(buffer, candidate.frame.data, candidate.frame.len);
+      return candidate.frame.len;
+    }
+    entry = &candidate;
+    break;
+  }
+
+  uint16_t values = 0;
+  size_t len = map.encode_reply(buffer, address, request, &values);
+  this->encodings_++;
+  // Wide reads are rare, only the short replies are kept
+  if (len > METER_MAX_RESPONSE_SIZE)
+    return len;
+
+  if (entry == nullptr) {
+    entry = &this->entries_[this->next_];
+    this->next_ = (this->next_ + 1) % METER_RESPONSE_CACHE_SIZE;
+  }
+  entry->address = address;
+  memcpy(entry->request, request, 5);
+  entry->values = values;
+  entry->generation = map.get_generation();
+  memcpy(entry->frame.data, buffer, len);
+  entry->frame.len = len;
+  return len;
 }
 
 }  // namespace esphome::solax_meter_modbus
@@ -1,12 +1,172 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
 #include "esphome/components/uart/uart.h"
 
+#include <atomic>
+#include <cstring>
 #include <vector>
 
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
 namespace esphome::solax_meter_modbus {
 
+// Keep reading this long after the last edge on the RX pin, the UART hands over its FIFO with a delay
+static const uint32_t RX_WAKEUP_HOLD_TIME = 50;
+
+// Minimum time between two warnings about requests to unknown addresses
+static const uint32_t UNKNOWN_ADDRESS_LOG_INTERVAL = 10000;
+
+// Address (1 byte) + function, register and register count (5 bytes) + CRC (2 bytes)
+static const uint8_t METER_REQUEST_SIZE = 8;
+
+// Address, function and byte count (3 bytes) + up to four registers (8 bytes) + CRC (2 bytes)
+static const uint8_t METER_MAX_RESPONSE_SIZE = 13;
+
+// Ready-to-send response frame
+struct SolaxMeterFrame {
+  uint8_t data[METER_MAX_RESPONSE_SIZE];
+  uint8_t len{0};
+};
+
+// Encodes a read response including the CRC into buffer and returns its length
+size_t encode_meter_response(uint8_t *buffer, uint8_t address, uint8_t function, const uint8_t *data,
+                             uint8_t data_len);
+
+// Modbus limit of registers per read request
+static const uint8_t METER_MAX_READ_REGISTERS = 125;
+
+// Address, function and byte count (3 bytes) + registers (250 bytes) + CRC (2 bytes)
+static const uint16_t METER_MAX_READ_RESPONSE_SIZE = 5 + 2 * METER_MAX_READ_REGISTERS;
+
+// Address, function and exception code (3 bytes) + CRC (2 bytes)
+static const uint8_t METER_EXCEPTION_RESPONSE_SIZE = 5;
+
+static const uint8_t MAX_METER_VALUES = 16;
+
+enum MeterException : uint8_t {
+  METER_EXCEPTION_ILLEGAL_FUNCTION = 0x01,
+  METER_EXCEPTION_ILLEGAL_DATA_ADDRESS = 0x02,
+  METER_EXCEPTION_ILLEGAL_DATA_VALUE = 0x03,
+};
+
+enum MeterRegisterType : uint8_t {
+  METER_REGISTER_RESERVED,  // Reads as zero
+  METER_REGISTER_FLOAT32,   // IEEE 754, high word first (2 registers)
+  METER_REGISTER_INT16,     // Signed integer (1 register)
+};
+
+// A contiguous block of registers which is backed by one value of the register map
+struct MeterRegister {
+  uint16_t address;
+  uint8_t count;
+  MeterRegisterType type;
+  uint8_t value;
+};
+
+// Table check for static_assert: sorted by address and without overlaps
+template<size_t N> constexpr bool meter_registers_valid(const MeterRegister (&registers)[N]) {
+  for (size_t i = 1; i < N; i++) {
+    if (registers[i - 1].address + registers[i - 1].count > registers[i].address)
+      return false;
+  }
+  return true;
+}
+
+// Answers read holding (0x03) and read input registers (0x04) requests of any width
+// from a register table. Both functions share the same address space.
+class SolaxMeterRegisterMap {
+ public:
+  template<size_t N> void set_registers(const MeterRegister (&registers)[N]) {
+    this->registers_ = registers;
+    this->registers_len_ = N;
+  }
+  void set_value(uint8_t value, float state) {
+    // Compared bitwise, NAN never equals itself
+    if (memcmp(&this->values_[value], &state, sizeof(state)) == 0)
+      return;
+    this->values_[value] = state;
+    this->changed_[value] = ++this->generation_;
+  }
+  float get_value(uint8_t value) const { return this->values_[value]; }
+
+  // Encodes the response or the exception response to a request (function, register and
+  // register count) into buffer and returns its length. The buffer must hold
+  // METER_MAX_READ_RESPONSE_SIZE bytes. Sets a bit in values for every value the response contains.
+  size_t encode_reply(uint8_t *buffer, uint8_t address, const uint8_t *request, uint16_t *values = nullptr) const;
+
+  // Incremented whenever a value changes
+  uint32_t get_generation() const { return this->generation_; }
+  // True if none of the values (one bit per value) changed after the given generation
+  bool is_unchanged_since(uint16_t values, uint32_t generation) const;
+
+ protected:
+  const MeterRegister *registers_{nullptr};
+  size_t registers_len_{0};
+  float values_[MAX_METER_VALUES]{};
+  uint32_t changed_[MAX_METER_VALUES]{};
+  uint32_t generation_{0};
+
+  uint16_t read_register_(const MeterRegister &block, uint16_t offset) const;
+};
+
+static const uint8_t METER_RESPONSE_CACHE_SIZE = 4;
+
+// Encoded replies to the recent requests of up to four registers. The inverter polls the same few registers
+// over and over, a reply is only encoded again if one of the values it contains changed.
+class SolaxMeterResponseCache {
+ public:
+  // Same as SolaxMeterRegisterMap::encode_reply, but copies the cached reply if it is still up to date
+  size_t encode_reply(const SolaxMeterRegisterMap &map, uint8_t *buffer, uint8_t address, const uint8_t *request);
+  uint32_t get_encodings() const { return this->encodings_; }
+
+ protected:
+  struct Entry {
+    uint8_t address;
+    // Function, register and register count
+    uint8_t request[5];
+    uint16_t values;
+    uint32_t generation;
+    SolaxMeterFrame frame;
+  };
+
+  Entry entries_[METER_RESPONSE_CACHE_SIZE]{};
+  uint8_t next_{0};
+  uint32_t encodings_{0};
+};
+
+// Encodes an exception response including the CRC into buffer and returns its length
+size_t encode_meter_exception(uint8_t *buffer, uint8_t address, uint8_t function, MeterException exception);
+
+// Request which was read (and possibly answered) by the bus task
+struct MeterRequest {
+  uint8_t frame[METER_REQUEST_SIZE];
+  uint32_t received_us;
+  uint32_t replied_us;
+  bool replied;
+};
+
+static const uint8_t METER_REQUEST_QUEUE_SIZE = 8;
+
+// Lock-free handoff of requests from the bus task (single producer) to the main loop (single consumer)
+class MeterRequestQueue {
+ public:
+  // Returns false and drops the request if the queue is full
+  bool push(const MeterRequest &request);
+  bool pop(MeterRequest *request);
+  uint32_t get_dropped() const { return this->dropped_; }
+
+ protected:
+  MeterRequest items_[METER_REQUEST_QUEUE_SIZE];
+  std::atomic<uint8_t> head_{0};
+  std::atomic<uint8_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
+
 class SolaxMeterModbusDevice;
 
 class SolaxMeterModbus : public uart::UARTDevice, public Component {
@@ -19,38 +179,111 @@ class SolaxMeterModbus : public uart::UARTDevice, public Component {
 
   void dump_config() override;
 
-  void register_device(SolaxMeterModbusDevice *device) { this->devices_.push_back(device); }
+  // The address of the device must be set before
+  void register_device(SolaxMeterModbusDevice *device);
 
   float get_setup_priority() const override;
 
+  uint32_t get_resync_count() const { return this->resync_count_; }
+  uint32_t get_discarded_bytes() const { return this->discarded_bytes_; }
+  uint32_t get_unknown_addresses() const { return this->unknown_addresses_; }
+
   void send(uint8_t address, int16_t power);
   void send(uint8_t address, float power);
   void send_raw(const std::vector<uint8_t> &payload);
+  void send_frame(const uint8_t *frame, size_t len);
   void set_flow_control_pin(GPIOPin *flow_control_pin) { this->flow_control_pin_ = flow_control_pin; }
+  void set_non_blocking_transmit(bool non_blocking_transmit) { this->non_blocking_transmit_ = non_blocking_transmit; }
+  // Read, answer and queue the requests in a dedicated task (ESP32 only)
+  void set_bus_task(bool bus_task) { this->bus_task_ = bus_task; }
+  bool is_bus_task() const { return this->bus_task_; }
+  // Only look at the UART after an edge on this pin (the UART RX pin) instead of polling it every loop
+  void set_rx_wakeup_pin(InternalGPIOPin *rx_wakeup_pin) {
+    this->rx_wakeup_pin_ = rx_wakeup_pin;
+    this->rx_wakeup_ = true;
+  }
+
+  // Time on the wire of len bytes with the configured UART settings
+  uint32_t get_transmit_time_us(size_t len) const;
 
  protected:
   GPIOPin *flow_control_pin_{nullptr};
+  bool non_blocking_transmit_{false};
+  bool transmitting_{false};
+  uint32_t transmit_end_us_{0};
+  HighFrequencyLoopRequester high_freq_;
+
+  void end_transmit_(size_t len);
+  void check_transmit_(uint32_t now_us);
+
+  bool bus_task_{false};
+  MeterRequestQueue requests_;
+  uint8_t task_reply_[METER_MAX_READ_RESPONSE_SIZE];
+#ifdef USE_ESP32
+  TaskHandle_t bus_task_handle_{nullptr};
+  static void bus_task(void *param);
+#endif
+
+  InternalGPIOPin *rx_wakeup_pin_{nullptr};
+  bool rx_wakeup_{false};
+  volatile bool rx_event_{false};
+  bool rx_active_{false};
+  uint32_t last_rx_event_{0};
+  static void gpio_intr(SolaxMeterModbus *arg);
+  bool rx_pending_(uint32_t now);
+
+  void read_rx_();
+  void process_requests_();
+  bool reply_from_bus_task_(const uint8_t *raw);
+  void dispatch_request_(const MeterRequest &request);
+  void log_unknown_address_(uint8_t address, uint32_t now);
 
   bool parse_solax_meter_modbus_byte_(uint8_t byte);
-  std::vector<uint8_t> rx_buffer_;
+  bool parse_rx_buffer_();
+  bool parse_solax_meter_modbus_frame_(const uint8_t *raw);
+  size_t find_frame_start_(size_t from) const;
+  uint8_t rx_buffer_[64];
+  uint8_t rx_buffer_len_{0};
   uint32_t last_solax_meter_modbus_byte_{0};
+  uint32_t request_received_us_{0};
+  // Counted by the reading side, read by the main loop
+  std::atomic<uint32_t> resync_count_{0};
+  std::atomic<uint32_t> discarded_bytes_{0};
+  uint32_t requests_dropped_logged_{0};
+  uint32_t unknown_addresses_{0};
+  // Requests to unknown addresses are logged at most once per UNKNOWN_ADDRESS_LOG_INTERVAL
+  uint32_t unknown_addresses_logged_{0};
+  uint32_t last_unknown_address_log_{0};
   std::vector<SolaxMeterModbusDevice *> devices_;
+  // Device per address, nullptr if no device uses the address. Read by the bus task
+  SolaxMeterModbusDevice *devices_by_address_[256]{};
 };
 
 class SolaxMeterModbusDevice {
  public:
   void set_parent(SolaxMeterModbus *parent) { parent_ = parent; }
   void set_address(uint8_t address) { address_ = address; }
-  virtual void on_solax_meter_modbus_data(const std::vector<uint8_t> &data) = 0;
+  virtual void on_solax_meter_modbus_data(const uint8_t *data, size_t len) = 0;
   virtual void send(int16_t power) { this->parent_->send(this->address_, power); }
   virtual void send(float power) { this->parent_->send(this->address_, power); }
   virtual void send_raw(const std::vector<uint8_t> &payload) { this->parent_->send_raw(payload); }
+  // Sends a fully encoded frame without any logging
+  virtual void send_frame(const uint8_t *frame, size_t len) { this->parent_->send_frame(frame, len); }
+  // Encodes the reply to a request (function, register and register count) into buffer. Called by the
+  // bus task, so it must neither log nor touch state the main loop writes. Returns 0 if the device replies
+  // from on_solax_meter_modbus_data.
+  virtual size_t encode_reply(const uint8_t *request, uint8_t *buffer) { return 0; }
 
  protected:
   friend SolaxMeterModbus;
 
-  SolaxMeterModbus *parent_;
-  uint8_t address_;
+  SolaxMeterModbus *parent_{nullptr};
+  uint8_t address_{0};
+  // micros() when the current request was read from the UART
+  uint32_t request_received_us_{0};
+  // The bus task already sent the reply to the current request at reply_sent_us_
+  bool reply_sent_{false};
+  uint32_t reply_sent_us_{0};
 };
 
 }  // namespace esphome::solax_meter_modbus
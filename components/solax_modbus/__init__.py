@@ -2,9 +2,19 @@ from esphome import pins
 import esphome.codegen as cg
 from esphome.components import uart
 import esphome.config_validation as cv
-from esphome.const import CONF_ADDRESS, CONF_FLOW_CONTROL_PIN, CONF_ID
+from esphome.const import (
+    CONF_ADDRESS,
+    CONF_FLOW_CONTROL_PIN,
+    CONF_ID,
+    CONF_NUMBER,
+    CONF_RX_PIN,
+    CONF_UART_ID,
+)
+from esphome.core import CORE
 from esphome.cpp_helpers import gpio_pin_expression
+import esphome.final_validate as fv
 
+AUTO_LOAD = ["sensor"]
 CODEOWNERS = ["@syssi"]
 
 DEPENDENCIES = ["uart"]
@@ -12,17 +22,64 @@ MULTI_CONF = True
 
 CONF_SOLAX_MODBUS_ID = "solax_modbus_id"
 CONF_SERIAL_NUMBER = "serial_number"
+CONF_RESPONSE_TIMEOUT = "response_timeout"
+CONF_NON_BLOCKING_TRANSMIT = "non_blocking_transmit"
+CONF_BUS_TASK = "bus_task"
+CONF_RX_WAKEUP_PIN = "rx_wakeup_pin"
+CONF_LISTEN_ONLY = "listen_only"
 
 solax_modbus_ns = cg.esphome_ns.namespace("solax_modbus")
 SolaxModbus = solax_modbus_ns.class_("SolaxModbus", cg.Component, uart.UARTDevice)
 SolaxModbusDevice = solax_modbus_ns.class_("SolaxModbusDevice")
 
+
+def validate_bus_task(value):
+    value = cv.boolean(value)
+    if value:
+        # The bus task is a FreeRTOS task pinned to a core
+        cv.only_on_esp32(value)
+    return value
+
+
+# RX pins of the ESP8266 hardware UART (GPIO13 if swapped),
+# any other RX pin is read by the software serial
+ESP8266_HARDWARE_UART_RX_PINS = [3, 13]
+
+
+def validate_rx_wakeup_uart(uart_config):
+    # The software serial of the ESP8266 receives from the interrupt of the RX pin,
+    # the wakeup interrupt would replace it
+    rx_pin = uart_config.get(CONF_RX_PIN)
+    if rx_pin is None or rx_pin[CONF_NUMBER] not in ESP8266_HARDWARE_UART_RX_PINS:
+        raise cv.Invalid(
+            f"{CONF_RX_WAKEUP_PIN} requires the hardware UART on the ESP8266 "
+            "(rx_pin GPIO3 or GPIO13)"
+        )
+    return uart_config
+
+
+def final_validate_rx_wakeup_pin(config):
+    if CONF_RX_WAKEUP_PIN in config and CORE.is_esp8266:
+        fv.id_declaration_match_schema(validate_rx_wakeup_uart)(config[CONF_UART_ID])
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate_rx_wakeup_pin
+
+
 CONFIG_SCHEMA = cv.All(
     cv.require_esphome_version(2024, 6, 0),
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(SolaxModbus),
             cv.Optional(CONF_FLOW_CONTROL_PIN): pins.gpio_output_pin_schema,
+            cv.Optional(
+                CONF_RESPONSE_TIMEOUT, default="250ms"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_LISTEN_ONLY, default=False): cv.boolean,
+            cv.Optional(CONF_NON_BLOCKING_TRANSMIT, default=False): cv.boolean,
+            cv.Optional(CONF_BUS_TASK, default=False): validate_bus_task,
+            cv.Optional(CONF_RX_WAKEUP_PIN): pins.internal_gpio_input_pin_schema,
         }
     )
     .extend(cv.COMPONENT_SCHEMA)
@@ -66,6 +123,16 @@ async def to_code(config):
         pin = await gpio_pin_expression(config[CONF_FLOW_CONTROL_PIN])
         cg.add(var.set_flow_control_pin(pin))
 
+    cg.add(var.set_discovery_key(config[CONF_ID].id))
+    cg.add(var.set_response_timeout(config[CONF_RESPONSE_TIMEOUT]))
+    cg.add(var.set_listen_only(config[CONF_LISTEN_ONLY]))
+    cg.add(var.set_non_blocking_transmit(config[CONF_NON_BLOCKING_TRANSMIT]))
+    cg.add(var.set_bus_task(config[CONF_BUS_TASK]))
+
+    if CONF_RX_WAKEUP_PIN in config:
+        pin = await gpio_pin_expression(config[CONF_RX_WAKEUP_PIN])
+        cg.add(var.set_rx_wakeup_pin(pin))
+
 
 def solax_modbus_device_schema(default_address, default_serial):
     schema = {
@@ -76,7 +143,7 @@ def solax_modbus_device_schema(default_address, default_serial):
     else:
         schema[cv.Optional(CONF_ADDRESS, default=default_address)] = cv.hex_uint8_t
 
-    if default_address is None:
+    if default_serial is None:
         schema[cv.Required(CONF_SERIAL_NUMBER)] = validate_serial_number
     else:
         schema[cv.Optional(CONF_SERIAL_NUMBER, default=default_serial)] = (
@@ -0,0 +1,110 @@
+import esphome.codegen as cg
+from esphome.components import sensor
+import esphome.config_validation as cv
+from esphome.const import (
+    CONF_ADDRESS,
+    CONF_UPDATE_INTERVAL,
+    DEVICE_CLASS_DURATION,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    ICON_COUNTER,
+    ICON_TIMER,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_EMPTY,
+    UNIT_MILLISECOND,
+)
+
+from . import CONF_SOLAX_MODBUS_ID, SolaxModbus
+
+DEPENDENCIES = ["solax_modbus"]
+CODEOWNERS = ["@syssi"]
+
+CONF_FRAMES_RECEIVED = "frames_received"
+CONF_CHECKSUM_ERRORS = "checksum_errors"
+CONF_HEADER_ERRORS = "header_errors"
+CONF_UNKNOWN_ADDRESSES = "unknown_addresses"
+CONF_UNHANDLED_CONTROL_CODES = "unhandled_control_codes"
+CONF_LOOP_TIME = "loop_time"
+CONF_LOOP_TIME_MAX = "loop_time_max"
+CONF_RESPONSE_LATENCY = "response_latency"
+CONF_MIN = "min"
+CONF_AVERAGE = "average"
+CONF_MAX = "max"
+CONF_P95 = "p95"
+
+UNIT_MICROSECOND = "µs"
+
+COUNTERS = [
+    CONF_FRAMES_RECEIVED,
+    CONF_CHECKSUM_ERRORS,
+    CONF_HEADER_ERRORS,
+    CONF_UNKNOWN_ADDRESSES,
+    CONF_UNHANDLED_CONTROL_CODES,
+]
+
+LATENCIES = [CONF_MIN, CONF_AVERAGE, CONF_MAX, CONF_P95]
+
+COUNTER_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_EMPTY,
+    icon=ICON_COUNTER,
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+LOOP_TIME_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MICROSECOND,
+    icon=ICON_TIMER,
+    accuracy_decimals=0,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+LATENCY_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MILLISECOND,
+    icon=ICON_TIMER,
+    accuracy_decimals=0,
+    device_class=DEVICE_CLASS_DURATION,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+RESPONSE_LATENCY_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_ADDRESS, default=0x0A): cv.hex_uint8_t,
+        **{cv.Optional(key): LATENCY_SCHEMA for key in LATENCIES},
+    }
+)
+
+CONFIG_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(CONF_SOLAX_MODBUS_ID): cv.use_id(SolaxModbus),
+        cv.Optional(
+            CONF_UPDATE_INTERVAL, default="60s"
+        ): cv.positive_time_period_milliseconds,
+        **{cv.Optional(key): COUNTER_SCHEMA for key in COUNTERS},
+        cv.Optional(CONF_LOOP_TIME): LOOP_TIME_SCHEMA,
+        cv.Optional(CONF_LOOP_TIME_MAX): LOOP_TIME_SCHEMA,
+        cv.Optional(CONF_RESPONSE_LATENCY): cv.ensure_list(RESPONSE_LATENCY_SCHEMA),
+    }
+)
+
+
+async def to_code(config):
+    hub = await cg.get_variable(config[CONF_SOLAX_MODBUS_ID])
+    cg.add(hub.set_statistics_interval(config[CONF_UPDATE_INTERVAL]))
+
+    for key in COUNTERS + [CONF_LOOP_TIME, CONF_LOOP_TIME_MAX]:
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(getattr(hub, f"set_{key}_sensor")(sens))
+
+    for latency_config in config.get(CONF_RESPONSE_LATENCY, []):
+        sensors = []
+        for key in LATENCIES:
+            if key in latency_config:
+                sensors.append(await sensor.new_sensor(latency_config[key]))
+            else:
+                sensors.append(cg.nullptr)
+        cg.add(hub.add_response_latency_sensors(latency_config[CONF_ADDRESS], *sensors))
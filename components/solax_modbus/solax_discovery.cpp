@@ -0,0 +1,196 @@
+#include "solax_discovery.h"
+#include "solax_modbus.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome::solax_modbus {
+
+static const char *const TAG = "solax_modbus.discovery";
+
+static const uint8_t MASTER_ADDRESS = 0x01;
+
+void SolaxDiscovery::setup(const std::vector<SolaxModbusDevice *> &devices, uint32_t hash) {
+  this->devices_ = devices;
+
+  // Two devices with the same address would both claim the frames of one inverter
+  // The configured addresses are kept, only the duplicates move to a free address
+  bool used[256]{};
+  used[0x00] = used[MASTER_ADDRESS] = used[BROADCAST_ADDRESS] = true;
+  std::vector<SolaxModbusDevice *> duplicates;
+  for (auto *device : this->devices_) {
+    if (used[device->address_]) {
+      duplicates.push_back(device);
+    } else {
+      used[device->address_] = true;
+    }
+  }
+  for (auto *device : duplicates) {
+    uint8_t address = SOLAX_FIRST_ADDRESS;
+    while (used[address] && address < BROADCAST_ADDRESS)
+      address++;
+    ESP_LOGW(TAG, "Address 0x%02X is already in use. Using 0x%02X instead", device->address_, address);
+    device->address_ = address;
+    used[address] = true;
+  }
+
+  for (size_t i = 0; i < this->devices_.size(); i++) {
+    for (size_t j = i + 1; j < this->devices_.size(); j++) {
+      const uint8_t *a = this->devices_[i]->serial_number_;
+      const uint8_t *b = this->devices_[j]->serial_number_;
+      if (a != nullptr && b != nullptr && memcmp(a, b, SOLAX_SERIAL_NUMBER_SIZE) == 0) {
+        ESP_LOGW(TAG, "Devices 0x%02X and 0x%02X have the same serial number. Their inverters can't be told apart",
+                 this->devices_[i]->address_, this->devices_[j]->address_);
+      }
+    }
+  }
+
+  // Drop the mappings which don't fit the configuration anymore
+  this->pref_ = global_preferences->make_preference<SolaxAddressMappings>(hash);
+  SolaxAddressMappings stored{};
+  if (!this->pref_.load(&stored))
+    return;
+
+  for (uint8_t i = 0; i < std::min(stored.count, MAX_ADDRESS_MAPPINGS); i++) {
+    const SolaxAddressMapping &mapping = stored.entries[i];
+    SolaxModbusDevice *device = this->find_device_(mapping.address);
+    if (device == nullptr)
+      continue;
+    if (device->serial_number_ != nullptr &&
+        memcmp(device->serial_number_, mapping.serial_number, SOLAX_SERIAL_NUMBER_SIZE) != 0 &&
+        this->devices_.size() > 1)
+      continue;
+
+    this->mappings_.entries[this->mappings_.count++] = mapping;
+  }
+  ESP_LOGD(TAG, "Restored %u address mappings", this->mappings_.count);
+}
+
+SolaxModbusDevice *SolaxDiscovery::assign(const uint8_t *serial_number) {
+  SolaxModbusDevice *device = nullptr;
+
+  // The address the inverter had before
+  const SolaxAddressMapping *mapping = this->find_mapping_(serial_number);
+  if (mapping != nullptr)
+    device = this->find_device_(mapping->address);
+
+  if (device == nullptr) {
+    for (auto *candidate : this->devices_) {
+      if (candidate->serial_number_ == nullptr ||
+          memcmp(candidate->serial_number_, serial_number, SOLAX_SERIAL_NUMBER_SIZE) == 0) {
+        device = candidate;
+        break;
+      }
+    }
+  }
+
+  // A single device takes any inverter, the serial number wasn't checked before multiple devices were supported
+  if (device == nullptr && this->devices_.size() == 1) {
+    device = this->devices_[0];
+    ESP_LOGW(TAG, "Serial number doesn't match the configured one. Assigning address 0x%02X anyway", device->address_);
+  }
+
+  if (device == nullptr)
+    return nullptr;
+
+  this->add_pending_(serial_number, device->address_);
+  return device;
+}
+
+bool SolaxDiscovery::confirm(uint8_t address) {
+  for (uint8_t i = 0; i < this->pending_.count; i++) {
+    if (this->pending_.entries[i].address != address)
+      continue;
+
+    this->store_mapping_(this->pending_.entries[i].serial_number, address);
+    this->remove_pending_(i);
+    return true;
+  }
+  return false;
+}
+
+void SolaxDiscovery::on_discovery_done(uint32_t now) {
+  this->backoff_exponent_ = 0;
+  this->next_discovery_ = now;
+}
+
+void SolaxDiscovery::on_discovery_collision(uint32_t now) {
+  this->collisions_++;
+  this->backoff_exponent_ = std::min<uint8_t>(this->backoff_exponent_ + 1, DISCOVERY_BACKOFF_MAX_EXPONENT);
+  uint32_t backoff = DISCOVERY_BACKOFF_MIN << (this->backoff_exponent_ - 1);
+  this->next_discovery_ = now + backoff;
+  ESP_LOGD(TAG, "Several inverters answered the discovery. Next discovery in %u ms", (unsigned) backoff);
+}
+
+const SolaxAddressMapping *SolaxDiscovery::find_mapping_(const uint8_t *serial_number) const {
+  for (uint8_t i = 0; i < this->mappings_.count; i++) {
+    if (memcmp(this->mappings_.entries[i].serial_number, serial_number, SOLAX_SERIAL_NUMBER_SIZE) == 0)
+      return &this->mappings_.entries[i];
+  }
+  return nullptr;
+}
+
+void SolaxDiscovery::add_pending_(const uint8_t *serial_number, uint8_t address) {
+  // Several inverters can answer one discovery after another before the first acknowledges its address
+  // A newer registration of the same address replaces the older one
+  for (uint8_t i = 0; i < this->pending_.count; i++) {
+    if (this->pending_.entries[i].address == address) {
+      this->remove_pending_(i);
+      break;
+    }
+  }
+  if (this->pending_.count == MAX_ADDRESS_MAPPINGS)
+    this->remove_pending_(0);
+
+  SolaxAddressMapping &pending = this->pending_.entries[this->pending_.count++];
+  memcpy(pending.serial_number, serial_number, SOLAX_SERIAL_NUMBER_SIZE);
+  pending.address = address;
+}
+
+void SolaxDiscovery::remove_pending_(uint8_t index) {
+  this->pending_.count--;
+  memmove(this->pending_.entries + index, this->pending_.entries + index + 1,
+          sizeof(SolaxAddressMapping) * (this->pending_.count - index));
+}
+
+SolaxModbusDevice *SolaxDiscovery::find_device_(uint8_t address) const {
+  for (auto *device : this->devices_) {
+    if (device->address_ == address)
+      return device;
+  }
+  return nullptr;
+}
+
+void SolaxDiscovery::store_mapping_(const uint8_t *serial_number, uint8_t address) {
+  SolaxAddressMappings mappings{};
+  bool changed = true;
+  for (uint8_t i = 0; i < this->mappings_.count; i++) {
+    const SolaxAddressMapping &mapping = this->mappings_.entries[i];
+    bool same_serial = memcmp(mapping.serial_number, serial_number, SOLAX_SERIAL_NUMBER_SIZE) == 0;
+    if (same_serial && mapping.address == address)
+      changed = false;
+    // Another inverter at this address or this inverter at another address
+    if (same_serial != (mapping.address == address))
+      continue;
+    mappings.entries[mappings.count++] = mapping;
+  }
+
+  // The inverters ask for their address every morning, the flash is only written if the mapping changed
+  if (!changed)
+    return;
+
+  if (mappings.count == MAX_ADDRESS_MAPPINGS) {
+    memmove(mappings.entries, mappings.entries + 1, sizeof(SolaxAddressMapping) * (MAX_ADDRESS_MAPPINGS - 1));
+    mappings.count--;
+  }
+  SolaxAddressMapping &mapping = mappings.entries[mappings.count++];
+  memcpy(mapping.serial_number, serial_number, SOLAX_SERIAL_NUMBER_SIZE);
+  mapping.address = address;
+
+  this->mappings_ = mappings;
+  this->pref_.save(&this->mappings_);
+  ESP_LOGD(TAG, "Address mapping of 0x%02X saved", address);
+}
+
+}  // namespace esphome::solax_modbus
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "esphome/core/preferences.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome::solax_modbus {
+
+static const uint8_t BROADCAST_ADDRESS = 0xFF;
+static const uint8_t SOLAX_SERIAL_NUMBER_SIZE = 14;
+static const uint8_t SOLAX_FIRST_ADDRESS = 0x0A;
+static const uint8_t MAX_ADDRESS_MAPPINGS = 8;
+
+// Pause between two discovery broadcasts after a garbled reply, doubled per collision in a row
+static const uint32_t DISCOVERY_BACKOFF_MIN = 1000;
+static const uint8_t DISCOVERY_BACKOFF_MAX_EXPONENT = 6;
+
+// Inverter serial number and the address it was registered with
+struct SolaxAddressMapping {
+  uint8_t serial_number[SOLAX_SERIAL_NUMBER_SIZE];
+  uint8_t address;
+};
+
+// Persisted, so the inverters get their previous address back when they ask for one after a reboot
+struct SolaxAddressMappings {
+  uint8_t count;
+  SolaxAddressMapping entries[MAX_ADDRESS_MAPPINGS];
+};
+
+class SolaxModbusDevice;
+
+// Matches discovered inverters to the registered devices and keeps track of the assigned addresses
+class SolaxDiscovery {
+ public:
+  // Makes the device addresses unique and restores the address mapping
+  void setup(const std::vector<SolaxModbusDevice *> &devices, uint32_t hash);
+
+  // Device the discovered inverter belongs to, nullptr if none
+  SolaxModbusDevice *assign(const uint8_t *serial_number);
+  // The inverter acknowledged the address. Returns false if no registration was pending for the address
+  bool confirm(uint8_t address);
+  uint8_t get_pending_count() const { return this->pending_.count; }
+
+  bool is_discovery_allowed(uint32_t now) const { return int32_t(now - this->next_discovery_) >= 0; }
+  // A discovery broadcast was answered by a single inverter or not at all
+  void on_discovery_done(uint32_t now);
+  // Several inverters answered a discovery broadcast at the same time
+  void on_discovery_collision(uint32_t now);
+
+  uint32_t get_collisions() const { return this->collisions_; }
+  const SolaxAddressMappings &get_mappings() const { return this->mappings_; }
+
+ protected:
+  const SolaxAddressMapping *find_mapping_(const uint8_t *serial_number) const;
+  SolaxModbusDevice *find_device_(uint8_t address) const;
+  void store_mapping_(const uint8_t *serial_number, uint8_t address);
+  void add_pending_(const uint8_t *serial_number, uint8_t address);
+  void remove_pending_(uint8_t index);
+
+  std::vector<SolaxModbusDevice *> devices_;
+  SolaxAddressMappings mappings_{};
+  ESPPreferenceObject pref_;
+
+  // Registrations waiting for the acknowledge of the inverter, at most one per address
+  SolaxAddressMappings pending_{};
+
+  uint32_t next_discovery_{0};
+  uint8_t backoff_exponent_{0};
+  uint32_t collisions_{0};
+};
+
+}  // namespace esphome::solax_modbus
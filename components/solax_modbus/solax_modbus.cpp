@@ -2,7 +2,8 @@
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
 
-static const uint8_t BROADCAST_ADDRESS = 0xFF;
+#include <algorithm>
+#include <cstring>
 
 namespace esphome::solax_modbus {
 
@@ -12,26 +13,143 @@ void SolaxModbus::setup() {
   if (this->flow_control_pin_ != nullptr) {
     this->flow_control_pin_->setup();
   }
+
+  this->discovery_.setup(this->devices_, this->discovery_hash_);
+  // The discovery moves devices away from duplicate addresses
+  this->update_device_table_();
+
+  if (this->rx_wakeup_pin_ != nullptr) {
+    // The pin is owned by the UART, only listen to its edges
+    this->rx_wakeup_pin_->attach_interrupt(SolaxModbus::gpio_intr, this, gpio::INTERRUPT_FALLING_EDGE);
+  }
+
+#ifdef USE_ESP32
+  if (this->bus_task_) {
+    // Above the priority of the main loop and pinned to the core the main loop runs on, away from Wi-Fi
+    xTaskCreatePinnedToCore(SolaxModbus::bus_task, "solax_bus", 4096, this, 5, &this->bus_task_handle_,
+                            portNUM_PROCESSORS - 1);
+  }
+#endif
 }
 
+#ifdef USE_ESP32
+void SolaxModbus::bus_task(void *param) {
+  auto *bus = static_cast<SolaxModbus *>(param);
+  while (true) {
+    bus->read_rx_();
+    vTaskDelay(1);
+  }
+}
+#endif
+
 void SolaxModbus::loop() {
+  const uint32_t start = micros();
+  this->check_transmit_(start);
+
   const uint32_t now = millis();
+  // The bus task reads and checks the frames, the main loop only dispatches them
+  if (this->bus_task_) {
+    this->process_frames_();
+  } else {
+    this->read_rx_();
+  }
+
+  this->process_transactions_(now);
+
+  uint32_t loop_time = micros() - start;
+  this->loop_time_sum_ += loop_time;
+  this->loop_time_max_ = std::max(this->loop_time_max_, loop_time);
+  this->loop_count_++;
+
+  if (this->statistics_interval_ > 0 && now - this->last_statistics_publish_ >= this->statistics_interval_) {
+    this->last_statistics_publish_ = now;
+    this->publish_statistics_();
+  }
+}
+
+void IRAM_ATTR SolaxModbus::gpio_intr(SolaxModbus *arg) {
+  arg->rx_event_ = true;
+  arg->enable_loop_soon_any_context();
+}
+
+bool SolaxModbus::rx_pending_(uint32_t now) {
+  if (!this->rx_wakeup_)
+    return true;
+
+  if (this->rx_event_) {
+    this->rx_event_ = false;
+    this->rx_active_ = true;
+    this->last_rx_event_ = now;
+  } else if (this->rx_active_ && this->rx_buffer_len_ == 0 && now - this->last_rx_event_ > RX_WAKEUP_HOLD_TIME) {
+    this->rx_active_ = false;
+  }
+
+  return this->rx_active_;
+}
+
+void SolaxModbus::read_rx_() {
+  const uint32_t now = millis();
+  // The line is idle, skip the parser entirely
+  if (!this->rx_pending_(now))
+    return;
+
   if (now - this->last_solax_modbus_byte_ > 50) {
-    this->rx_buffer_.clear();
+    this->discard_stale_frames_();
     this->last_solax_modbus_byte_ = now;
   }
 
-  while (this->available()) {
-    uint8_t byte;
-    this->read_byte(&byte);
-    if (this->parse_solax_modbus_byte_(byte)) {
-      this->last_solax_modbus_byte_ = now;
-    } else {
-      this->rx_buffer_.clear();
-    }
+  // Drain everything available with a single read per buffer fill instead of a read_byte() per byte
+  size_t available = this->available();
+  while (available > 0) {
+    size_t len = std::min(available, size_t(SOLAX_MAX_FRAME_SIZE - this->rx_buffer_len_));
+    if (!this->read_array(this->rx_buffer_ + this->rx_buffer_len_, len))
+      break;
+    this->rx_buffer_len_ += len;
+    available -= len;
+
+    this->parse_rx_buffer_();
+    this->last_solax_modbus_byte_ = now;
   }
 }
 
+void SolaxModbus::process_frames_() {
+  while (this->frames_.pop(&this->frame_)) {
+    this->dispatch_solax_modbus_frame_(this->frame_.data, this->frame_.len, this->frame_.received);
+  }
+
+  // The bus task doesn't log, report its drops from here
+  uint32_t dropped = this->frames_.get_dropped();
+  if (dropped != this->frames_dropped_logged_) {
+    ESP_LOGW(TAG, "Frame queue full. %u frames dropped", (unsigned) (dropped - this->frames_dropped_logged_));
+    this->frames_dropped_logged_ = dropped;
+  }
+}
+
+bool SolaxFrameQueue::push(const uint8_t *frame, size_t len, uint32_t received) {
+  uint8_t tail = this->tail_.load(std::memory_order_relaxed);
+  uint8_t next = (tail + 1) % SOLAX_FRAME_QUEUE_SIZE;
+  if (next == this->head_.load(std::memory_order_acquire)) {
+    this->dropped_++;
+    return false;
+  }
+
+  memcpy(this->items_[tail].data, frame, len);
+  this->items_[tail].len = len;
+  this->items_[tail].received = received;
+  this->tail_.store(next, std::memory_order_release);
+  return true;
+}
+
+bool SolaxFrameQueue::pop(SolaxFrame *frame) {
+  uint8_t head = this->head_.load(std::memory_order_relaxed);
+  if (head == this->tail_.load(std::memory_order_acquire))
+    return false;
+
+  *frame = this->items_[head];
+  this->head_.store((head + 1) % SOLAX_FRAME_QUEUE_SIZE, std::memory_order_release);
+  return true;
+}
+
 std::string hexencode_plain(const uint8_t *data, uint32_t len) {
   char buf[20];
   std::string res;
@@ -42,183 +160,490 @@ std::string hexencode_plain(const uint8_t *data, uint32_t len) {
   return res;
 }
 
-uint16_t chksum(const uint8_t data[], const uint8_t len) {
-  uint8_t i;
+uint16_t chksum(const uint8_t data[], const size_t len) {
   uint16_t checksum = 0;
-  for (i = 0; i <= len; i++) {
+  // Frames are up to 266 bytes long, an 8 bit index would never reach the end
+  for (size_t i = 0; i <= len; i++) {
     checksum = checksum + data[i];
   }
   return checksum;
 }
 
 bool SolaxModbus::parse_solax_modbus_byte_(uint8_t byte) {
-  size_t at = this->rx_buffer_.size();
-  this->rx_buffer_.push_back(byte);
-  const uint8_t *frame = &this->rx_buffer_[0];
-
-  // Byte 0: modbus address (match all)
-  if (at == 0)
-    return true;
+  this->rx_buffer_[this->rx_buffer_len_++] = byte;
+  return this->parse_rx_buffer_();
+}
 
-  // Byte 1: Function (msb indicates error)
-  if (at == 1)
-    return (byte & 0x80) != 0x80;
+bool SolaxModbus::parse_rx_buffer_() {
+  size_t pos = 0;
+
+  while (pos < this->rx_buffer_len_) {
+    const uint8_t *frame = this->rx_buffer_ + pos;
+    size_t remaining = this->rx_buffer_len_ - pos;
+
+    bool valid = true;
+    // Byte 0...1: header
+    if (frame[0] != 0xAA || (remaining > 1 && frame[1] != 0x55)) {
+      // The bus task only counts the errors
+      if (!this->bus_task_)
+        ESP_LOGW(TAG, "Invalid header");
+      this->header_errors_++;
+      valid = false;
+    } else {
+      // Byte 8: data length
+      if (remaining < SOLAX_HEADER_SIZE)
+        break;
+
+      // Byte 9...9+data_len-1: Data, Byte 9+data_len...9+data_len+1: checksum
+      size_t frame_len = SOLAX_HEADER_SIZE + frame[8] + 2;
+      if (remaining < frame_len)
+        break;
+
+      valid = this->parse_solax_modbus_frame_(frame, frame_len);
+      if (valid)
+        pos += frame_len;
+    }
 
-  if (at == 2)
-    return true;
+    if (!valid) {
+      // Skip to the next header candidate instead of dropping everything buffered
+      size_t next = this->find_frame_start_(pos + 1);
+      if (!this->bus_task_)
+        ESP_LOGD(TAG, "Resynchronizing. %zu bytes discarded", next - pos);
+      this->resync_count_++;
+      this->discarded_bytes_ += next - pos;
+      pos = next;
+    }
+  }
 
-  // Byte 3: solax device address
-  if (at == 3)
-    return true;
-  uint8_t address = frame[3];
+  // Keep the incomplete frame at the front of the buffer
+  if (pos > 0) {
+    this->rx_buffer_len_ -= pos;
+    memmove(this->rx_buffer_, this->rx_buffer_ + pos, this->rx_buffer_len_);
+  }
 
-  // Byte 9: data length
-  if (at < 9)
-    return true;
+  bool receiving = this->rx_buffer_len_ > 0;
+  this->receiving_.store(receiving, std::memory_order_relaxed);
+  return receiving;
+}
 
-  uint8_t data_len = frame[8];
-  // Byte 9...9+data_len-1: Data
-  if (at < 9 + data_len)
-    return true;
+void SolaxModbus::discard_stale_frames_() {
+  // The frame at the front will never complete, e.g. because its length byte is corrupted. Drop only its
+  // header, the bytes behind it may still hold good frames
+  while (this->rx_buffer_len_ > 0) {
+    size_t next = this->find_frame_start_(1);
+    if (!this->bus_task_)
+      ESP_LOGD(TAG, "Incomplete frame timed out. %zu bytes discarded", next);
+    this->resync_count_++;
+    this->discarded_bytes_ += next;
+    this->rx_buffer_len_ -= next;
+    memmove(this->rx_buffer_, this->rx_buffer_ + next, this->rx_buffer_len_);
+    this->parse_rx_buffer_();
+  }
+}
 
-  // Byte 9+data_len: CRC_LO (over all bytes)
-  if (at == 9 + data_len)
-    return true;
+size_t SolaxModbus::find_frame_start_(size_t from) const {
+  for (size_t i = from; i < this->rx_buffer_len_; i++) {
+    // A trailing 0xAA might be the start of a header split across reads
+    if (this->rx_buffer_[i] == 0xAA && (i + 1 == this->rx_buffer_len_ || this->rx_buffer_[i + 1] == 0x55))
+      return i;
+  }
+  return this->rx_buffer_len_;
+}
 
-  ESP_LOGVV(TAG, "RX <- %s", format_hex_pretty(frame, at + 1).c_str());  // NOLINT
+bool SolaxModbus::parse_solax_modbus_frame_(const uint8_t *frame, size_t frame_len) {
+  ESP_LOGVV(TAG, "RX <- %s", format_hex_pretty(frame, frame_len).c_str());  // NOLINT
 
-  if (frame[0] != 0xAA || frame[1] != 0x55) {
-    ESP_LOGW(TAG, "Invalid header");
-    return false;
-  }
+  uint8_t data_len = frame[8];
 
-  // Byte 9+data_len+1: CRC_HI (over all bytes)
   uint16_t computed_checksum = chksum(frame, 9 + data_len - 1);
   uint16_t remote_checksum = uint16_t(frame[9 + data_len + 1]) | (uint16_t(frame[9 + data_len]) << 8);
   if (computed_checksum != remote_checksum) {
-    ESP_LOGW(TAG, "Invalid checksum! 0x%02X !=  0x%02X", computed_checksum, remote_checksum);
+    if (!this->bus_task_)
+      ESP_LOGW(TAG, "Invalid checksum! 0x%02X !=  0x%02X", computed_checksum, remote_checksum);
+    this->checksum_errors_++;
     return false;
   }
+  this->frames_received_++;
+
+  if (!this->bus_task_) {
+    this->dispatch_solax_modbus_frame_(frame, frame_len, millis());
+    return true;
+  }
+
+  // Leave everything else to the main loop, it also reports the dropped frames
+  this->frames_.push(frame, frame_len, millis());
+  return true;
+}
+
+void SolaxModbus::dispatch_solax_modbus_frame_(const uint8_t *frame, size_t frame_len, uint32_t received) {
+  uint8_t address = frame[3];
+  uint8_t data_len = frame[8];
+
+  // Requests of the other master have the msb of the function code cleared
+  if (this->listen_only_ && (frame[7] & 0x80) == 0) {
+    this->observe_request_(frame, received);
+    return;
+  }
+
+  // The response function code is the request function code with the msb set
+  if (this->waiting_for_response_ && address == this->active_transaction_.response_address &&
+      frame[6] == this->active_transaction_.control_code &&
+      frame[7] == (this->active_transaction_.function_code | 0x80)) {
+    this->waiting_for_response_ = false;
+    this->record_response_latency_(address, received - this->last_send_);
+  }
 
   // data only
-  std::vector<uint8_t> data(this->rx_buffer_.begin() + 9, this->rx_buffer_.begin() + 9 + data_len);
+  const uint8_t *data = frame + SOLAX_HEADER_SIZE;
 
   if (address == BROADCAST_ADDRESS) {
     // check control code && function code
-    if (frame[6] == 0x10 && frame[7] == 0x80 && data.size() == 14) {
-      ESP_LOGI(TAG, "Inverter discovered. Serial number: %s", hexencode_plain(&data.front(), data.size()).c_str());
-      this->register_address(data.data(), 0x0A);
+    if (frame[6] == 0x10 && frame[7] == 0x80 && data_len == 14) {
+      ESP_LOGI(TAG, "Inverter discovered. Serial number: %s", hexencode_plain(data, data_len).c_str());
+      // The other master assigns the address
+      if (this->listen_only_)
+        return;
+
+      this->discovery_.on_discovery_done(received);
+      SolaxModbusDevice *device = this->discovery_.assign(data);
+      if (device == nullptr) {
+        ESP_LOGW(TAG, "No device configured for this serial number");
+        return;
+      }
+      this->register_address(data, device->address_);
     } else {
-      ESP_LOGW(TAG, "Unknown broadcast data: %s", format_hex_pretty(&data.front(), data.size()).c_str());  // NOLINT
+      ESP_LOGW(TAG, "Unknown broadcast data: %s", format_hex_pretty(data, data_len).c_str());  // NOLINT
     }
 
-    // early return false to reset buffer
-    return false;
+    return;
   }
 
-  bool found = false;
-  for (auto *device : this->devices_) {
-    if (device->address_ == address) {
-      if (frame[6] == 0x11) {
-        device->on_solax_modbus_data(frame[7], data);
-      } else {
-        ESP_LOGW(TAG, "Unhandled control code (%d) of frame for address 0x%02X: %s", frame[6], address,
-                 format_hex_pretty(frame, at + 1).c_str());  // NOLINT
-      }
-      found = true;
+  // Register address confirmation
+  if (frame[6] == 0x10 && frame[7] == 0x81) {
+    if (this->listen_only_) {
+      ESP_LOGI(TAG, "Inverter registered with address 0x%02X by the other master", address);
+    } else if (this->discovery_.confirm(address)) {
+      ESP_LOGI(TAG, "Inverter registered with address 0x%02X", address);
+    } else {
+      ESP_LOGW(TAG, "Unexpected address confirmation from address 0x%02X", address);
     }
+    return;
   }
 
-  if (!found) {
-    ESP_LOGW(TAG, "Got solax frame from unknown device address 0x%02X!", address);
+  SolaxModbusDevice *device = this->devices_by_address_[address];
+  if (device == nullptr) {
+    this->log_unknown_address_(address, received);
+    return;
   }
 
-  // return false to reset buffer
-  return false;
+  if (frame[6] == 0x11) {
+    device->on_solax_modbus_data(frame[7], data, data_len);
+  } else {
+    ESP_LOGW(TAG, "Unhandled control code (%d) of frame for address 0x%02X: %s", frame[6], address,
+             format_hex_pretty(frame, frame_len).c_str());  // NOLINT
+    this->unhandled_control_codes_++;
+  }
+}
+
+void SolaxModbus::observe_request_(const uint8_t *frame, uint32_t received) {
+  // Track the request like an own transaction to match the response and measure the latency
+  SolaxTransactionT request{};
+  request.source = frame[2];
+  request.address = frame[5];
+  request.response_address = frame[5];
+  request.control_code = frame[6];
+  request.function_code = frame[7];
+
+  if (frame[6] == 0x10 && frame[7] == 0x00) {
+    request.response_address = BROADCAST_ADDRESS;
+  } else if (frame[6] == 0x10 && frame[7] == 0x01 && frame[8] == SOLAX_SERIAL_NUMBER_SIZE + 1) {
+    const uint8_t *data = frame + SOLAX_HEADER_SIZE;
+    request.response_address = data[SOLAX_SERIAL_NUMBER_SIZE];
+    ESP_LOGI(TAG, "The other master registers serial number %s with address 0x%02X",
+             hexencode_plain(data, SOLAX_SERIAL_NUMBER_SIZE).c_str(), request.response_address);
+  }
+
+  ESP_LOGV(TAG, "Request 0x%02X to address 0x%02X observed", request.function_code, request.address);
+  this->observed_requests_++;
+  this->active_transaction_ = request;
+  this->waiting_for_response_ = true;
+  this->last_send_ = received;
+}
+
+void SolaxModbus::log_unknown_address_(uint8_t address, uint32_t now) {
+  this->unknown_addresses_++;
+
+  // Another master on the bus produces one of these per frame
+  if (this->unknown_addresses_logged_ > 0 && now - this->last_unknown_address_log_ < UNKNOWN_ADDRESS_LOG_INTERVAL)
+    return;
+
+  ESP_LOGW(TAG, "Got solax frame from unknown device address 0x%02X! %u such frames since last warning", address,
+           (unsigned) (this->unknown_addresses_ - this->unknown_addresses_logged_));
+  this->unknown_addresses_logged_ = this->unknown_addresses_;
+  this->last_unknown_address_log_ = now;
+}
+
+void SolaxModbus::register_device(SolaxModbusDevice *device) {
+  this->devices_.push_back(device);
+  if (this->devices_by_address_[device->address_] == nullptr)
+    this->devices_by_address_[device->address_] = device;
+}
+
+void SolaxModbus::update_device_table_() {
+  memset(this->devices_by_address_, 0, sizeof(this->devices_by_address_));
+  for (auto *device : this->devices_) {
+    if (this->devices_by_address_[device->address_] == nullptr)
+      this->devices_by_address_[device->address_] = device;
+  }
 }
 
 void SolaxModbus::dump_config() {
   ESP_LOGCONFIG(TAG, "SolaxModbus:");
   LOG_PIN("  Flow Control Pin: ", this->flow_control_pin_);
+  LOG_PIN("  RX Wakeup Pin: ", this->rx_wakeup_pin_);
+  ESP_LOGCONFIG(TAG, "  Listen only: %s", YESNO(this->listen_only_));
+  ESP_LOGCONFIG(TAG, "  Non-blocking transmit: %s", YESNO(this->non_blocking_transmit_));
+  ESP_LOGCONFIG(TAG, "  Bus task: %s", YESNO(this->bus_task_));
+  ESP_LOGCONFIG(TAG, "  Response Timeout: %u ms", this->response_timeout_);
+  for (auto *device : this->devices_) {
+    ESP_LOGCONFIG(TAG, "  Device 0x%02X, serial number: %s", device->address_,
+                  device->serial_number_ != nullptr
+                      ? hexencode_plain(device->serial_number_, SOLAX_SERIAL_NUMBER_SIZE).c_str()
+                      : "any");
+  }
+  LOG_SENSOR("  ", "Frames received", this->frames_received_sensor_);
+  LOG_SENSOR("  ", "Checksum errors", this->checksum_errors_sensor_);
+  LOG_SENSOR("  ", "Header errors", this->header_errors_sensor_);
+  LOG_SENSOR("  ", "Unknown addresses", this->unknown_addresses_sensor_);
+  LOG_SENSOR("  ", "Unhandled control codes", this->unhandled_control_codes_sensor_);
+  LOG_SENSOR("  ", "Loop time", this->loop_time_sensor_);
+  LOG_SENSOR("  ", "Loop time max", this->loop_time_max_sensor_);
+  for (auto &stats : this->response_latencies_) {
+    ESP_LOGCONFIG(TAG, "  Response latency of address 0x%02X:", stats.address);
+    LOG_SENSOR("    ", "Min", stats.min_sensor);
+    LOG_SENSOR("    ", "Average", stats.avg_sensor);
+    LOG_SENSOR("    ", "Max", stats.max_sensor);
+    LOG_SENSOR("    ", "P95", stats.p95_sensor);
+  }
 
   this->check_uart_settings(9600);
 }
 
+void SolaxModbus::add_response_latency_sensors(uint8_t address, sensor::Sensor *min_sensor,
+                                               sensor::Sensor *avg_sensor, sensor::Sensor *max_sensor,
+                                               sensor::Sensor *p95_sensor) {
+  SolaxLatencyStatistics stats{};
+  stats.address = address;
+  stats.min_sensor = min_sensor;
+  stats.avg_sensor = avg_sensor;
+  stats.max_sensor = max_sensor;
+  stats.p95_sensor = p95_sensor;
+  this->response_latencies_.push_back(stats);
+}
+
+void SolaxModbus::record_response_latency_(uint8_t address, uint32_t latency) {
+  for (auto &stats : this->response_latencies_) {
+    if (stats.address != address)
+      continue;
+
+    stats.samples[stats.head] = std::min(latency, uint32_t(UINT16_MAX));
+    stats.head = (stats.head + 1) % LATENCY_SAMPLES;
+    if (stats.count < LATENCY_SAMPLES)
+      stats.count++;
+  }
+}
+
+void SolaxModbus::publish_statistics_() {
+  this->publish_state_(this->frames_received_sensor_, this->frames_received_);
+  this->publish_state_(this->checksum_errors_sensor_, this->checksum_errors_);
+  this->publish_state_(this->header_errors_sensor_, this->header_errors_);
+  this->publish_state_(this->unknown_addresses_sensor_, this->unknown_addresses_);
+  this->publish_state_(this->unhandled_control_codes_sensor_, this->unhandled_control_codes_);
+
+  // Loop time since the last publish
+  if (this->loop_count_ > 0) {
+    this->publish_state_(this->loop_time_sensor_, (float) this->loop_time_sum_ / this->loop_count_);
+    this->publish_state_(this->loop_time_max_sensor_, this->loop_time_max_);
+  }
+  this->loop_time_sum_ = 0;
+  this->loop_time_max_ = 0;
+  this->loop_count_ = 0;
+
+  // Response latency of the most recent transactions
+  for (auto &stats : this->response_latencies_) {
+    if (stats.count == 0)
+      continue;
+
+    uint16_t sorted[LATENCY_SAMPLES];
+    memcpy(sorted, stats.samples, stats.count * sizeof(uint16_t));
+    std::sort(sorted, sorted + stats.count);
+
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < stats.count; i++)
+      sum += sorted[i];
+
+    this->publish_state_(stats.min_sensor, sorted[0]);
+    this->publish_state_(stats.avg_sensor, (float) sum / stats.count);
+    this->publish_state_(stats.max_sensor, sorted[stats.count - 1]);
+    this->publish_state_(stats.p95_sensor, sorted[(stats.count * 95 + 99) / 100 - 1]);
+  }
+}
+
+void SolaxModbus::publish_state_(sensor::Sensor *sensor, float value) {
+  if (sensor == nullptr)
+    return;
+
+  sensor->publish_state(value);
+}
+
 float SolaxModbus::get_setup_priority() const {
   // After UART bus
   return setup_priority::BUS - 1.0f;
 }
 
 void SolaxModbus::query_status_report(uint8_t address) {
-  static SolaxMessageT tx_message;
-
-  tx_message.Source[0] = 0x01;
-  tx_message.Source[1] = 0x00;
-  tx_message.Destination[0] = 0x00;
-  tx_message.Destination[1] = address;
-  tx_message.ControlCode = 0x11;
-  tx_message.FunctionCode = 0x02;
-  tx_message.DataLength = 0x00;
-
-  this->send(&tx_message);
+  SolaxTransactionT transaction{};
+  transaction.source = 0x01;
+  transaction.address = address;
+  transaction.response_address = address;
+  transaction.control_code = 0x11;
+  transaction.function_code = 0x02;
+
+  this->queue_transaction_(transaction);
 }
 
 void SolaxModbus::query_device_info(uint8_t address) {
-  static SolaxMessageT tx_message;
+  SolaxTransactionT transaction{};
+  transaction.source = 0x01;
+  transaction.address = address;
+  transaction.response_address = address;
+  transaction.control_code = 0x11;
+  transaction.function_code = 0x03;
+
+  this->queue_transaction_(transaction);
+}
 
-  tx_message.Source[0] = 0x01;
-  tx_message.Source[1] = 0x00;
-  tx_message.Destination[0] = 0x00;
-  tx_message.Destination[1] = address;
-  tx_message.ControlCode = 0x11;
-  tx_message.FunctionCode = 0x03;
-  tx_message.DataLength = 0x00;
+void SolaxModbus::query_config_settings(uint8_t address) {
+  SolaxTransactionT transaction{};
+  transaction.source = 0x01;
+  transaction.address = address;
+  transaction.response_address = address;
+  transaction.control_code = 0x11;
+  transaction.function_code = 0x04;
+
+  this->queue_transaction_(transaction);
+}
 
-  this->send(&tx_message);
+void SolaxModbus::register_address(const uint8_t *serial_number, uint8_t address) {
+  SolaxTransactionT transaction{};
+  transaction.source = 0x00;
+  transaction.address = 0x00;
+  // The inverter acknowledges from its new address
+  transaction.response_address = address;
+  transaction.control_code = 0x10;
+  transaction.function_code = 0x01;
+  transaction.data_length = 0x0F;
+  memcpy(transaction.data, serial_number, 14);
+  transaction.data[14] = address;
+
+  this->queue_transaction_(transaction);
 }
 
-void SolaxModbus::query_config_settings(uint8_t address) {
-  static SolaxMessageT tx_message;
+void SolaxModbus::discover_devices() {
+  if (!this->discovery_.is_discovery_allowed(millis())) {
+    ESP_LOGD(TAG, "Discovery backing off after a collision");
+    return;
+  }
 
-  tx_message.Source[0] = 0x01;
-  tx_message.Source[1] = 0x00;
-  tx_message.Destination[0] = 0x00;
-  tx_message.Destination[1] = address;
-  tx_message.ControlCode = 0x11;
-  tx_message.FunctionCode = 0x04;
-  tx_message.DataLength = 0x00;
+  SolaxTransactionT transaction{};
+  transaction.source = 0x01;
+  transaction.address = 0x00;
+  transaction.response_address = BROADCAST_ADDRESS;
+  transaction.control_code = 0x10;
+  transaction.function_code = 0x00;
 
-  this->send(&tx_message);
+  this->queue_transaction_(transaction);
 }
 
-void SolaxModbus::register_address(uint8_t serial_number[14], uint8_t address) {
-  static SolaxMessageT tx_message;
+static bool is_same_request(const SolaxTransactionT &a, const SolaxTransactionT &b) {
+  if (a.address != b.address || a.control_code != b.control_code || a.function_code != b.function_code)
+    return false;
 
-  tx_message.Source[0] = 0x00;
-  tx_message.Source[1] = 0x00;
-  tx_message.Destination[0] = 0x00;
-  tx_message.Destination[1] = 0x00;
-  tx_message.ControlCode = 0x10;
-  tx_message.FunctionCode = 0x01;
-  tx_message.DataLength = 0x0F;
-  memcpy(tx_message.Data, serial_number, 14);
-  tx_message.Data[14] = address;
+  // All registrations go to address 0x00, they differ by the serial number and the assigned address
+  return a.response_address == b.response_address && a.data_length == b.data_length &&
+         memcmp(a.data, b.data, a.data_length) == 0;
+}
 
-  this->send(&tx_message);
+void SolaxModbus::queue_transaction_(const SolaxTransactionT &transaction) {
+  if (this->listen_only_) {
+    ESP_LOGV(TAG, "Listen only. Request 0x%02X to address 0x%02X not sent", transaction.function_code,
+             transaction.address);
+    return;
+  }
+
+  for (uint8_t i = 0; i < this->queue_len_; i++) {
+    const SolaxTransactionT &queued = this->queue_[(this->queue_head_ + i) % MAX_QUEUED_TRANSACTIONS];
+    if (is_same_request(queued, transaction)) {
+      ESP_LOGV(TAG, "Request 0x%02X to address 0x%02X is already queued", transaction.function_code,
+               transaction.address);
+      return;
+    }
+  }
+
+  if (this->queue_len_ == MAX_QUEUED_TRANSACTIONS) {
+    ESP_LOGW(TAG, "Transaction queue full. Dropping request 0x%02X to address 0x%02X", transaction.function_code,
+             transaction.address);
+    return;
+  }
+
+  this->queue_[(this->queue_head_ + this->queue_len_) % MAX_QUEUED_TRANSACTIONS] = transaction;
+  this->queue_len_++;
 }
 
-void SolaxModbus::discover_devices() {
-  static SolaxMessageT tx_message;
+void SolaxModbus::process_transactions_(uint32_t now) {
+  if (this->waiting_for_response_) {
+    if (now - this->last_send_ < this->response_timeout_)
+      return;
+
+    ESP_LOGD(TAG, "No response to request 0x%02X from address 0x%02X within %u ms",
+             this->active_transaction_.function_code, this->active_transaction_.response_address,
+             this->response_timeout_);
+    this->waiting_for_response_ = false;
 
-  tx_message.Source[0] = 0x01;
+    // The replies of several inverters to the same discovery broadcast garble each other
+    if (this->active_transaction_.response_address == BROADCAST_ADDRESS && !this->listen_only_) {
+      if (this->checksum_errors_ + this->header_errors_ != this->discovery_errors_) {
+        this->discovery_.on_discovery_collision(now);
+      } else {
+        this->discovery_.on_discovery_done(now);
+      }
+    }
+  }
+
+  // Don't talk over a frame in reception
+  if (this->queue_len_ == 0 || this->receiving_.load(std::memory_order_relaxed))
+    return;
+
+  this->active_transaction_ = this->queue_[this->queue_head_];
+  this->queue_head_ = (this->queue_head_ + 1) % MAX_QUEUED_TRANSACTIONS;
+  this->queue_len_--;
+
+  static SolaxMessageT tx_message;
+  tx_message.Source[0] = this->active_transaction_.source;
   tx_message.Source[1] = 0x00;
   tx_message.Destination[0] = 0x00;
-  tx_message.Destination[1] = 0x00;
-  tx_message.ControlCode = 0x10;
-  tx_message.FunctionCode = 0x00;
-  tx_message.DataLength = 0x00;
+  tx_message.Destination[1] = this->active_transaction_.address;
+  tx_message.ControlCode = this->active_transaction_.control_code;
+  tx_message.FunctionCode = this->active_transaction_.function_code;
+  tx_message.DataLength = this->active_transaction_.data_length;
+  memcpy(tx_message.Data, this->active_transaction_.data, this->active_transaction_.data_length);
+
+  if (this->active_transaction_.response_address == BROADCAST_ADDRESS)
+    this->discovery_errors_ = this->checksum_errors_ + this->header_errors_;
 
   this->send(&tx_message);
+  this->waiting_for_response_ = true;
+  this->last_send_ = now;
 }
 
 void SolaxModbus::send(SolaxMessageT *tx_message) {
@@ -240,10 +665,44 @@ void SolaxModbus::send(SolaxMessageT *tx_message) {
     this->flow_control_pin_->digital_write(true);
 
   this->write_array((const uint8_t *) tx_message, msg_len);
-  this->flush();
+  this->end_transmit_(msg_len);
+}
+
+void SolaxModbus::end_transmit_(size_t len) {
+  if (!this->non_blocking_transmit_) {
+    this->flush();
+    if (this->flow_control_pin_ != nullptr)
+      this->flow_control_pin_->digital_write(false);
+    return;
+  }
+
+  // The UART shifts the frame out in the background. The flow control pin is released
+  // by loop() once the last byte left the wire (plus one byte time as guard)
+  uint32_t now = micros();
+  uint32_t duration = this->get_transmit_time_us(len + 1);
+  if (this->transmitting_ && int32_t(this->transmit_end_us_ - now) > 0) {
+    this->transmit_end_us_ += duration;
+  } else {
+    this->transmit_end_us_ = now + duration;
+  }
+  this->transmitting_ = true;
+  this->high_freq_.start();
+}
+
+void SolaxModbus::check_transmit_(uint32_t now_us) {
+  if (!this->transmitting_ || int32_t(now_us - this->transmit_end_us_) < 0)
+    return;
 
   if (this->flow_control_pin_ != nullptr)
     this->flow_control_pin_->digital_write(false);
+  this->transmitting_ = false;
+  this->high_freq_.stop();
+}
+
+uint32_t SolaxModbus::get_transmit_time_us(size_t len) const {
+  uint32_t bits = 1 + this->parent_->get_data_bits() + this->parent_->get_stop_bits() +
+                  (this->parent_->get_parity() != uart::UART_CONFIG_PARITY_NONE ? 1 : 0);
+  return uint64_t(len) * bits * 1000000 / this->parent_->get_baud_rate();
 }
 
 }  // namespace esphome::solax_modbus
@@ -1,10 +1,30 @@
 #pragma once
 
 #include "esphome/core/component.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/sensor/sensor.h"
 #include "esphome/components/uart/uart.h"
+#include "solax_discovery.h"
+
+#include <atomic>
+
+#ifdef USE_ESP32
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
 
 namespace esphome::solax_modbus {
 
+// Keep reading this long after the last edge on the RX pin, the UART hands over its FIFO with a delay
+static const uint32_t RX_WAKEUP_HOLD_TIME = 50;
+
+// Minimum time between two warnings about frames of unknown addresses
+static const uint32_t UNKNOWN_ADDRESS_LOG_INTERVAL = 10000;
+
+// Header (9 bytes) + data (up to 255 bytes) + checksum (2 bytes)
+static const uint8_t SOLAX_HEADER_SIZE = 9;
+static const uint16_t SOLAX_MAX_FRAME_SIZE = SOLAX_HEADER_SIZE + 255 + 2;
+
 struct SolaxMessageT {
   uint8_t Header[2];
   uint8_t Source[2];
@@ -15,6 +35,59 @@ struct SolaxMessageT {
   uint8_t Data[100];
 };
 
+// Pending request of the transaction queue
+struct SolaxTransactionT {
+  uint8_t source;
+  uint8_t address;
+  // Source address of the expected response
+  uint8_t response_address;
+  uint8_t control_code;
+  uint8_t function_code;
+  uint8_t data_length;
+  uint8_t data[15];
+};
+
+static const uint8_t MAX_QUEUED_TRANSACTIONS = 16;
+
+// Number of recent request-to-response latencies kept per device
+static const uint8_t LATENCY_SAMPLES = 32;
+
+// Response latency window of a device address and its optional sensors
+struct SolaxLatencyStatistics {
+  uint8_t address{0};
+  uint16_t samples[LATENCY_SAMPLES]{};
+  uint8_t head{0};
+  uint8_t count{0};
+  sensor::Sensor *min_sensor{nullptr};
+  sensor::Sensor *avg_sensor{nullptr};
+  sensor::Sensor *max_sensor{nullptr};
+  sensor::Sensor *p95_sensor{nullptr};
+};
+
+// Frame which passed the checksum check in the bus task
+struct SolaxFrame {
+  uint8_t data[SOLAX_MAX_FRAME_SIZE];
+  uint16_t len;
+  uint32_t received;
+};
+
+static const uint8_t SOLAX_FRAME_QUEUE_SIZE = 4;
+
+// Lock-free handoff of frames from the bus task (single producer) to the main loop (single consumer)
+class SolaxFrameQueue {
+ public:
+  // Returns false and drops the frame if the queue is full
+  bool push(const uint8_t *frame, size_t len, uint32_t received);
+  bool pop(SolaxFrame *frame);
+  uint32_t get_dropped() const { return this->dropped_; }
+
+ protected:
+  SolaxFrame items_[SOLAX_FRAME_QUEUE_SIZE];
+  std::atomic<uint8_t> head_{0};
+  std::atomic<uint8_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+};
+
 class SolaxModbusDevice;
 
 class SolaxModbus : public uart::UARTDevice, public Component {
@@ -26,25 +99,150 @@ class SolaxModbus : public uart::UARTDevice, public Component {
 
   void dump_config() override;
 
-  void register_device(SolaxModbusDevice *device) { this->devices_.push_back(device); }
+  // The address of the device must be set before
+  void register_device(SolaxModbusDevice *device);
   void set_flow_control_pin(GPIOPin *flow_control_pin) { this->flow_control_pin_ = flow_control_pin; }
+  void set_response_timeout(uint16_t response_timeout) { this->response_timeout_ = response_timeout; }
+  void set_statistics_interval(uint32_t statistics_interval) { this->statistics_interval_ = statistics_interval; }
+  void set_non_blocking_transmit(bool non_blocking_transmit) { this->non_blocking_transmit_ = non_blocking_transmit; }
+  // Never transmit, decode the traffic of another master instead
+  void set_listen_only(bool listen_only) { this->listen_only_ = listen_only; }
+  bool is_listen_only() const { return this->listen_only_; }
+  // Read and check the frames in a dedicated task (ESP32 only)
+  void set_bus_task(bool bus_task) { this->bus_task_ = bus_task; }
+  // Only look at the UART after an edge on this pin (the UART RX pin) instead of polling it every loop.
+  // The loop keeps running for the request queue, on an idle line it only skips the available() call
+  void set_rx_wakeup_pin(InternalGPIOPin *rx_wakeup_pin) {
+    this->rx_wakeup_pin_ = rx_wakeup_pin;
+    this->rx_wakeup_ = true;
+  }
+  // Key of the persisted address mapping, unique per bus
+  void set_discovery_key(const std::string &key) { this->discovery_hash_ = fnv1_hash("solax_modbus_discovery_" + key); }
+
+  void set_frames_received_sensor(sensor::Sensor *sensor) { this->frames_received_sensor_ = sensor; }
+  void set_checksum_errors_sensor(sensor::Sensor *sensor) { this->checksum_errors_sensor_ = sensor; }
+  void set_header_errors_sensor(sensor::Sensor *sensor) { this->header_errors_sensor_ = sensor; }
+  void set_unknown_addresses_sensor(sensor::Sensor *sensor) { this->unknown_addresses_sensor_ = sensor; }
+  void set_unhandled_control_codes_sensor(sensor::Sensor *sensor) { this->unhandled_control_codes_sensor_ = sensor; }
+  void set_loop_time_sensor(sensor::Sensor *sensor) { this->loop_time_sensor_ = sensor; }
+  void set_loop_time_max_sensor(sensor::Sensor *sensor) { this->loop_time_max_sensor_ = sensor; }
+  void add_response_latency_sensors(uint8_t address, sensor::Sensor *min_sensor, sensor::Sensor *avg_sensor,
+                                    sensor::Sensor *max_sensor, sensor::Sensor *p95_sensor);
 
   float get_setup_priority() const override;
 
-  void send(SolaxMessageT *tx_message);
+  uint32_t get_resync_count() const { return this->resync_count_; }
+  uint32_t get_discarded_bytes() const { return this->discarded_bytes_; }
+  uint32_t get_frames_received() const { return this->frames_received_; }
+  uint32_t get_checksum_errors() const { return this->checksum_errors_; }
+  uint32_t get_header_errors() const { return this->header_errors_; }
+  uint32_t get_unknown_addresses() const { return this->unknown_addresses_; }
+  uint32_t get_unhandled_control_codes() const { return this->unhandled_control_codes_; }
+  uint32_t get_observed_requests() const { return this->observed_requests_; }
+  const SolaxDiscovery &get_discovery() const { return this->discovery_; }
+
+  // Time on the wire of len bytes with the configured UART settings
+  uint32_t get_transmit_time_us(size_t len) const;
+
+  virtual void send(SolaxMessageT *tx_message);
   void query_status_report(uint8_t address);
   void query_device_info(uint8_t address);
   void query_config_settings(uint8_t address);
   void discover_devices();
-  void register_address(uint8_t serial_number[14], uint8_t address);
+  void register_address(const uint8_t *serial_number, uint8_t address);
 
  protected:
   bool parse_solax_modbus_byte_(uint8_t byte);
+  bool parse_rx_buffer_();
+  bool parse_solax_modbus_frame_(const uint8_t *frame, size_t frame_len);
+  void dispatch_solax_modbus_frame_(const uint8_t *frame, size_t frame_len, uint32_t received);
+  void update_device_table_();
+  void observe_request_(const uint8_t *frame, uint32_t received);
+  void log_unknown_address_(uint8_t address, uint32_t now);
+  InternalGPIOPin *rx_wakeup_pin_{nullptr};
+  bool rx_wakeup_{false};
+  volatile bool rx_event_{false};
+  bool rx_active_{false};
+  uint32_t last_rx_event_{0};
+  static void gpio_intr(SolaxModbus *arg);
+  bool rx_pending_(uint32_t now);
+
+  void read_rx_();
+  void process_frames_();
+  size_t find_frame_start_(size_t from) const;
+  void discard_stale_frames_();
+  void queue_transaction_(const SolaxTransactionT &transaction);
+  void process_transactions_(uint32_t now);
+  void record_response_latency_(uint8_t address, uint32_t latency);
+  void publish_statistics_();
+  void publish_state_(sensor::Sensor *sensor, float value);
+  void end_transmit_(size_t len);
+  void check_transmit_(uint32_t now_us);
   GPIOPin *flow_control_pin_{nullptr};
+  bool listen_only_{false};
+  uint32_t observed_requests_{0};
+  bool non_blocking_transmit_{false};
+  bool transmitting_{false};
+  uint32_t transmit_end_us_{0};
+  HighFrequencyLoopRequester high_freq_;
 
-  std::vector<uint8_t> rx_buffer_;
+  bool bus_task_{false};
+  SolaxFrameQueue frames_;
+  SolaxFrame frame_;
+#ifdef USE_ESP32
+  TaskHandle_t bus_task_handle_{nullptr};
+  static void bus_task(void *param);
+#endif
+
+  // Only touched by the reading side (the bus task if enabled)
+  uint8_t rx_buffer_[SOLAX_MAX_FRAME_SIZE];
+  uint16_t rx_buffer_len_{0};
   uint32_t last_solax_modbus_byte_{0};
+  // A frame is partially received, the main loop doesn't send in the meantime
+  std::atomic<bool> receiving_{false};
+  // Counted by the reading side, read by the main loop
+  std::atomic<uint32_t> resync_count_{0};
+  std::atomic<uint32_t> discarded_bytes_{0};
+  std::atomic<uint32_t> frames_received_{0};
+  std::atomic<uint32_t> checksum_errors_{0};
+  std::atomic<uint32_t> header_errors_{0};
+  uint32_t frames_dropped_logged_{0};
+
+  uint32_t unknown_addresses_{0};
+  // Frames of unknown addresses are logged at most once per UNKNOWN_ADDRESS_LOG_INTERVAL
+  uint32_t unknown_addresses_logged_{0};
+  uint32_t last_unknown_address_log_{0};
+  uint32_t unhandled_control_codes_{0};
+  uint32_t loop_time_sum_{0};
+  uint32_t loop_time_max_{0};
+  uint32_t loop_count_{0};
+  uint32_t statistics_interval_{0};
+  uint32_t last_statistics_publish_{0};
+  std::vector<SolaxLatencyStatistics> response_latencies_;
+
+  sensor::Sensor *frames_received_sensor_{nullptr};
+  sensor::Sensor *checksum_errors_sensor_{nullptr};
+  sensor::Sensor *header_errors_sensor_{nullptr};
+  sensor::Sensor *unknown_addresses_sensor_{nullptr};
+  sensor::Sensor *unhandled_control_codes_sensor_{nullptr};
+  sensor::Sensor *loop_time_sensor_{nullptr};
+  sensor::Sensor *loop_time_max_sensor_{nullptr};
+
+  SolaxTransactionT queue_[MAX_QUEUED_TRANSACTIONS];
+  uint8_t queue_head_{0};
+  uint8_t queue_len_{0};
+  SolaxTransactionT active_transaction_{};
+  bool waiting_for_response_{false};
+  uint32_t last_send_{0};
+  uint16_t response_timeout_{250};
   std::vector<SolaxModbusDevice *> devices_;
+  // Device per address, nullptr if no device uses the address
+  SolaxModbusDevice *devices_by_address_[256]{};
+
+  SolaxDiscovery discovery_;
+  uint32_t discovery_hash_{fnv1_hash("solax_modbus_discovery")};
+  // Bus errors before the discovery broadcast, more afterwards mean that several inverters answered
+  uint32_t discovery_errors_{0};
 };
 
 class SolaxModbusDevice {
@@ -52,19 +250,22 @@ class SolaxModbusDevice {
   void set_parent(SolaxModbus *parent) { parent_ = parent; }
   void set_address(uint8_t address) { address_ = address; }
   void set_serial_number(uint8_t *serial_number) { serial_number_ = serial_number; }
-  virtual void on_solax_modbus_data(const uint8_t &function, const std::vector<uint8_t> &data) = 0;
+  // The data pointer is only valid for the duration of the call
+  virtual void on_solax_modbus_data(const uint8_t &function, const uint8_t *data, size_t len) = 0;
 
   void query_status_report(uint8_t address) { this->parent_->query_status_report(address); }
   void query_device_info(uint8_t address) { this->parent_->query_device_info(address); }
   void query_config_settings(uint8_t address) { this->parent_->query_config_settings(address); }
   void discover_devices() { this->parent_->discover_devices(); }
+  bool is_listen_only() const { return this->parent_->is_listen_only(); }
 
  protected:
   friend SolaxModbus;
+  friend SolaxDiscovery;
 
-  SolaxModbus *parent_;
-  uint8_t address_;
-  uint8_t *serial_number_;
+  SolaxModbus *parent_{nullptr};
+  uint8_t address_{0};
+  uint8_t *serial_number_{nullptr};
 };
 
 }  // namespace esphome::solax_modbus
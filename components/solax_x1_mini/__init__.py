@@ -1,18 +1,31 @@
 import esphome.codegen as cg
-from esphome.components import solax_modbus
+from esphome.components import solax_modbus, web_server_base
+from esphome.components.web_server_base import CONF_WEB_SERVER_BASE_ID
 import esphome.config_validation as cv
-from esphome.const import CONF_ID
+from esphome.const import CONF_ID, CONF_PATH
 
 AUTO_LOAD = ["solax_modbus", "sensor", "text_sensor"]
 CODEOWNERS = ["@syssi"]
 MULTI_CONF = True
 
 CONF_SOLAX_X1_MINI_ID = "solax_x1_mini_id"
+CONF_ADAPTIVE_POLLING = "adaptive_polling"
+CONF_MIN_UPDATE_INTERVAL = "min_update_interval"
+CONF_MAX_UPDATE_INTERVAL = "max_update_interval"
+CONF_POWER_CHANGE_THRESHOLD = "power_change_threshold"
+CONF_PUBLISH_UNCHANGED_EVERY = "publish_unchanged_every"
+CONF_CONFIG_SETTINGS_INTERVAL = "config_settings_interval"
+CONF_HISTORY = "history"
+CONF_CAPACITY = "capacity"
+CONF_WEB_EXPORT = "web_export"
 
 solax_x1_mini_ns = cg.esphome_ns.namespace("solax_x1_mini")
 SolaxX1Mini = solax_x1_mini_ns.class_(
     "SolaxX1Mini", cg.PollingComponent, solax_modbus.SolaxModbusDevice
 )
+StatusSensorSlot = solax_x1_mini_ns.enum("StatusSensorSlot")
+ConfigSensorSlot = solax_x1_mini_ns.enum("ConfigSensorSlot")
+HistoryWebHandler = solax_x1_mini_ns.class_("HistoryWebHandler", cg.Component)
 
 CONF_SOLAX_X1_MINI_COMPONENT_SCHEMA = cv.Schema(
     {
@@ -20,9 +33,69 @@ CONF_SOLAX_X1_MINI_COMPONENT_SCHEMA = cv.Schema(
     }
 )
 
+
+def validate_adaptive_polling(config):
+    if config[CONF_MIN_UPDATE_INTERVAL] > config[CONF_MAX_UPDATE_INTERVAL]:
+        raise cv.Invalid(
+            f"{CONF_MIN_UPDATE_INTERVAL} must not be greater than {CONF_MAX_UPDATE_INTERVAL}"
+        )
+    return config
+
+
+ADAPTIVE_POLLING_SCHEMA = cv.All(
+    cv.Schema(
+        {
+            cv.Optional(
+                CONF_MIN_UPDATE_INTERVAL, default="5s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_MAX_UPDATE_INTERVAL, default="300s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_POWER_CHANGE_THRESHOLD, default=50): cv.positive_float,
+        }
+    ),
+    validate_adaptive_polling,
+)
+
+HISTORY_SCHEMA = cv.Schema(
+    {
+        # 24 h of 10 s samples (190 kB), 1 h (8 kB) on the ESP8266
+        cv.SplitDefault(
+            CONF_CAPACITY,
+            esp8266=360,
+            esp32=8640,
+            rp2040=8640,
+            bk72xx=8640,
+            rtl87xx=8640,
+            host=8640,
+        ): cv.int_range(min=1, max=65535),
+        cv.Optional(CONF_WEB_EXPORT): cv.Schema(
+            {
+                cv.GenerateID(): cv.declare_id(HistoryWebHandler),
+                cv.GenerateID(CONF_WEB_SERVER_BASE_ID): cv.use_id(
+                    web_server_base.WebServerBase
+                ),
+                cv.Optional(CONF_PATH, default="/solax_x1_mini/history"): cv.string,
+            }
+        ).extend(cv.COMPONENT_SCHEMA),
+    }
+)
+
 CONFIG_SCHEMA = cv.All(
     cv.require_esphome_version(2024, 6, 0),
-    cv.Schema({cv.GenerateID(): cv.declare_id(SolaxX1Mini)})
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.declare_id(SolaxX1Mini),
+            cv.Optional(CONF_ADAPTIVE_POLLING): ADAPTIVE_POLLING_SCHEMA,
+            cv.Optional(CONF_PUBLISH_UNCHANGED_EVERY, default=1): cv.int_range(
+                min=1, max=65535
+            ),
+            cv.Optional(
+                CONF_CONFIG_SETTINGS_INTERVAL, default="24h"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_HISTORY): HISTORY_SCHEMA,
+        }
+    )
     .extend(cv.polling_component_schema("30s"))
     .extend(
         solax_modbus.solax_modbus_device_schema(0x0A, "3132333435363737363534333231")
@@ -34,3 +107,24 @@ async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
     await solax_modbus.register_solax_modbus_device(var, config)
+    cg.add(var.set_publish_unchanged_every(config[CONF_PUBLISH_UNCHANGED_EVERY]))
+    cg.add(var.set_config_settings_interval(config[CONF_CONFIG_SETTINGS_INTERVAL]))
+
+    if adaptive_polling := config.get(CONF_ADAPTIVE_POLLING):
+        cg.add(
+            var.set_adaptive_polling(
+                adaptive_polling[CONF_MIN_UPDATE_INTERVAL],
+                adaptive_polling[CONF_MAX_UPDATE_INTERVAL],
+                adaptive_polling[CONF_POWER_CHANGE_THRESHOLD],
+            )
+        )
+
+    if history := config.get(CONF_HISTORY):
+        cg.add(var.set_history_capacity(history[CONF_CAPACITY]))
+
+        if web_export := history.get(CONF_WEB_EXPORT):
+            cg.add_define("USE_SOLAX_X1_MINI_HISTORY_WEB")
+            base = await cg.get_variable(web_export[CONF_WEB_SERVER_BASE_ID])
+            handler = cg.new_Pvariable(web_export[CONF_ID], base, var)
+            await cg.register_component(handler, web_export)
+            cg.add(handler.set_path(web_export[CONF_PATH]))
@@ -0,0 +1,67 @@
+#include "history_web_handler.h"
+
+#ifdef USE_SOLAX_X1_MINI_HISTORY_WEB
+
+#include "esphome/core/log.h"
+
+#include <memory>
+
+namespace esphome::solax_x1_mini {
+
+static const char *const TAG = "solax_x1_mini.history";
+
+static const char *const CSV_SUFFIX = ".csv";
+static const char *const BINARY_SUFFIX = ".bin";
+
+void HistoryWebHandler::setup() {
+  this->base_->init();
+  this->base_->add_handler(this);
+}
+
+bool HistoryWebHandler::canHandle(AsyncWebServerRequest *request) const {
+  if (request->method() != HTTP_GET)
+    return false;
+
+  std::string url = request->url().c_str();
+  return url == this->path_ + CSV_SUFFIX || url == this->path_ + BINARY_SUFFIX;
+}
+
+void HistoryWebHandler::handleRequest(AsyncWebServerRequest *request) {
+  std::string url = request->url().c_str();
+  HistoryFormat format = url == this->path_ + BINARY_SUFFIX ? HISTORY_FORMAT_BINARY : HISTORY_FORMAT_CSV;
+  const char *content_type = format == HISTORY_FORMAT_BINARY ? "application/octet-stream" : "text/csv";
+
+  // Runs in the web server task while the main loop keeps recording. The exporter copies every sample
+  // with StatusHistory::read(), samples recorded while the response is streamed aren't part of it
+#ifdef USE_ARDUINO
+  auto exporter = std::make_shared<HistoryExporter>(&this->parent_->get_history(), format, millis());
+  AsyncWebServerResponse *response = request->beginChunkedResponse(
+      content_type,
+      [exporter](uint8_t *buffer, size_t max_len, size_t index) -> size_t { return exporter->read(buffer, max_len); });
+  request->send(response);
+#else
+  HistoryExporter exporter(&this->parent_->get_history(), format, millis());
+  httpd_req_t *req = *request;
+  httpd_resp_set_type(req, content_type);
+
+  uint8_t buffer[512];
+  size_t len;
+  while ((len = exporter.read(buffer, sizeof(buffer))) > 0) {
+    if (httpd_resp_send_chunk(req, (const char *) buffer, len) != ESP_OK) {
+      ESP_LOGW(TAG, "History export aborted by the client");
+      return;
+    }
+  }
+  httpd_resp_send_chunk(req, nullptr, 0);
+#endif
+}
+
+void HistoryWebHandler::dump_config() {
+  ESP_LOGCONFIG(TAG, "History web export:");
+  ESP_LOGCONFIG(TAG, "  CSV: %s%s", this->path_.c_str(), CSV_SUFFIX);
+  ESP_LOGCONFIG(TAG, "  Binary: %s%s", this->path_.c_str(), BINARY_SUFFIX);
+}
+
+}  // namespace esphome::solax_x1_mini
+
+#endif  // USE_SOLAX_X1_MINI_HISTORY_WEB
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef USE_SOLAX_X1_MINI_HISTORY_WEB
+
+#include "esphome/core/component.h"
+#include "esphome/components/web_server_base/web_server_base.h"
+#include "solax_x1_mini.h"
+
+#include <string>
+
+namespace esphome::solax_x1_mini {
+
+// Serves the history as <path>.csv and <path>.bin
+class HistoryWebHandler : public AsyncWebHandler, public Component {
+ public:
+  HistoryWebHandler(web_server_base::WebServerBase *base, SolaxX1Mini *parent) : base_(base), parent_(parent) {}
+
+  void set_path(const std::string &path) { this->path_ = path; }
+
+  bool canHandle(AsyncWebServerRequest *request) const override;
+  void handleRequest(AsyncWebServerRequest *request) override;
+  bool isRequestHandlerTrivial() const override { return false; }
+
+  void setup() override;
+  void dump_config() override;
+  float get_setup_priority() const override { return setup_priority::WIFI - 1.0f; }
+
+ protected:
+  web_server_base::WebServerBase *base_;
+  SolaxX1Mini *parent_;
+  std::string path_;
+};
+
+}  // namespace esphome::solax_x1_mini
+
+#endif  // USE_SOLAX_X1_MINI_HISTORY_WEB
@@ -11,6 +11,7 @@ from esphome.const import (
     DEVICE_CLASS_POWER,
     DEVICE_CLASS_TEMPERATURE,
     DEVICE_CLASS_VOLTAGE,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     ICON_COUNTER,
     ICON_EMPTY,
     ICON_TIMER,
@@ -21,11 +22,18 @@ from esphome.const import (
     UNIT_EMPTY,
     UNIT_HERTZ,
     UNIT_KILOWATT_HOURS,
+    UNIT_PERCENT,
+    UNIT_SECOND,
     UNIT_VOLT,
     UNIT_WATT,
 )
 
-from . import CONF_SOLAX_X1_MINI_COMPONENT_SCHEMA, CONF_SOLAX_X1_MINI_ID
+from . import (
+    CONF_SOLAX_X1_MINI_COMPONENT_SCHEMA,
+    CONF_SOLAX_X1_MINI_ID,
+    ConfigSensorSlot,
+    StatusSensorSlot,
+)
 
 DEPENDENCIES = ["solax_x1_mini"]
 CODEOWNERS = ["@syssi"]
@@ -49,11 +57,30 @@ CONF_TEMPERATURE_FAULT = "temperature_fault"
 CONF_PV1_VOLTAGE_FAULT = "pv1_voltage_fault"
 CONF_PV2_VOLTAGE_FAULT = "pv2_voltage_fault"
 CONF_GFC_FAULT = "gfc_fault"
+CONF_DEADBAND = "deadband"
+
+CONF_PV_START_VOLTAGE = "pv_start_voltage"
+CONF_START_TIME = "start_time"
+CONF_AC_VOLTAGE_MIN_PROTECT = "ac_voltage_min_protect"
+CONF_AC_VOLTAGE_MAX_PROTECT = "ac_voltage_max_protect"
+CONF_AC_FREQUENCY_MIN_PROTECT = "ac_frequency_min_protect"
+CONF_AC_FREQUENCY_MAX_PROTECT = "ac_frequency_max_protect"
+CONF_DCI_LIMIT = "dci_limit"
+CONF_GRID_AVERAGE_VOLTAGE_PROTECT = "grid_average_voltage_protect"
+CONF_AC_VOLTAGE_MIN_SLOW_PROTECT = "ac_voltage_min_slow_protect"
+CONF_AC_VOLTAGE_MAX_SLOW_PROTECT = "ac_voltage_max_slow_protect"
+CONF_AC_FREQUENCY_MIN_SLOW_PROTECT = "ac_frequency_min_slow_protect"
+CONF_AC_FREQUENCY_MAX_SLOW_PROTECT = "ac_frequency_max_slow_protect"
+CONF_SAFETY = "safety"
+CONF_POWER_FACTOR_MODE = "power_factor_mode"
+CONF_POWER_LIMIT = "power_limit"
 
 UNIT_HOURS = "h"
+UNIT_MILLIAMPERE = "mA"
 
 ICON_MODE = "mdi:heart-pulse"
 ICON_ERROR_BITS = "mdi:alert-circle-outline"
+ICON_SAFETY = "mdi:shield-check-outline"
 
 # key: sensor_schema kwargs
 SENSOR_DEFS = {
@@ -189,11 +216,110 @@ SENSOR_DEFS = {
     },
 }
 
+# Config settings, fetched on a long interval. key: sensor_schema kwargs
+CONFIG_SENSOR_DEFS = {
+    CONF_PV_START_VOLTAGE: {
+        "unit_of_measurement": UNIT_VOLT,
+        "accuracy_decimals": 1,
+        "device_class": DEVICE_CLASS_VOLTAGE,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_START_TIME: {
+        "unit_of_measurement": UNIT_SECOND,
+        "icon": ICON_TIMER,
+        "accuracy_decimals": 0,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_VOLTAGE_MIN_PROTECT: {
+        "unit_of_measurement": UNIT_VOLT,
+        "accuracy_decimals": 1,
+        "device_class": DEVICE_CLASS_VOLTAGE,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_VOLTAGE_MAX_PROTECT: {
+        "unit_of_measurement": UNIT_VOLT,
+        "accuracy_decimals": 1,
+        "device_class": DEVICE_CLASS_VOLTAGE,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_FREQUENCY_MIN_PROTECT: {
+        "unit_of_measurement": UNIT_HERTZ,
+        "accuracy_decimals": 2,
+        "device_class": DEVICE_CLASS_FREQUENCY,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_FREQUENCY_MAX_PROTECT: {
+        "unit_of_measurement": UNIT_HERTZ,
+        "accuracy_decimals": 2,
+        "device_class": DEVICE_CLASS_FREQUENCY,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_DCI_LIMIT: {
+        "unit_of_measurement": UNIT_MILLIAMPERE,
+        "accuracy_decimals": 0,
+        "device_class": DEVICE_CLASS_CURRENT,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_GRID_AVERAGE_VOLTAGE_PROTECT: {
+        "unit_of_measurement": UNIT_VOLT,
+        "accuracy_decimals": 1,
+        "device_class": DEVICE_CLASS_VOLTAGE,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_VOLTAGE_MIN_SLOW_PROTECT: {
+        "unit_of_measurement": UNIT_VOLT,
+        "accuracy_decimals": 1,
+        "device_class": DEVICE_CLASS_VOLTAGE,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_VOLTAGE_MAX_SLOW_PROTECT: {
+        "unit_of_measurement": UNIT_VOLT,
+        "accuracy_decimals": 1,
+        "device_class": DEVICE_CLASS_VOLTAGE,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_FREQUENCY_MIN_SLOW_PROTECT: {
+        "unit_of_measurement": UNIT_HERTZ,
+        "accuracy_decimals": 2,
+        "device_class": DEVICE_CLASS_FREQUENCY,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_AC_FREQUENCY_MAX_SLOW_PROTECT: {
+        "unit_of_measurement": UNIT_HERTZ,
+        "accuracy_decimals": 2,
+        "device_class": DEVICE_CLASS_FREQUENCY,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_SAFETY: {
+        "icon": ICON_SAFETY,
+        "accuracy_decimals": 0,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_POWER_FACTOR_MODE: {
+        "accuracy_decimals": 0,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    CONF_POWER_LIMIT: {
+        "unit_of_measurement": UNIT_PERCENT,
+        "accuracy_decimals": 0,
+        "entity_category": ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+}
+
 CONFIG_SCHEMA = CONF_SOLAX_X1_MINI_COMPONENT_SCHEMA.extend(
     {
-        cv.Optional(key): sensor.sensor_schema(**kwargs)
+        cv.Optional(key): sensor.sensor_schema(**kwargs).extend(
+            {
+                cv.Optional(CONF_DEADBAND): cv.positive_float,
+            }
+        )
         for key, kwargs in SENSOR_DEFS.items()
     }
+).extend(
+    {
+        cv.Optional(key): sensor.sensor_schema(**kwargs)
+        for key, kwargs in CONFIG_SENSOR_DEFS.items()
+    }
 )
 
 
@@ -204,3 +330,11 @@ async def to_code(config):
             conf = config[key]
             sens = await sensor.new_sensor(conf)
             cg.add(getattr(hub, f"set_{key}_sensor")(sens))
+            if CONF_DEADBAND in conf:
+                slot = getattr(StatusSensorSlot, f"SLOT_{key.upper()}")
+                cg.add(hub.set_deadband(slot, conf[CONF_DEADBAND]))
+    for key in CONFIG_SENSOR_DEFS:
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            slot = getattr(ConfigSensorSlot, f"CONFIG_SLOT_{key.upper()}")
+            cg.add(hub.set_config_sensor(slot, sens))
@@ -1,6 +1,11 @@
 #include "solax_x1_mini.h"
 #include "esphome/core/log.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
 namespace esphome::solax_x1_mini {
 
 static const char *const TAG = "solax_x1_mini";
@@ -11,6 +16,7 @@ static const uint8_t FUNCTION_CONFIG_SETTINGS = 0x84;
 
 // SolaxPower Single Phase External Communication Protocol - X1 Series V1.2.pdf
 // SolaxPower Single Phase External Communication Protocol - X1 Series V1.8.pdf
+static const uint8_t MODE_WAIT = 0;
 static const uint8_t MODES_SIZE = 7;
 static constexpr const char *const MODES[MODES_SIZE] = {
     "Wait",             // 0
@@ -59,64 +65,212 @@ static constexpr const char *const ERRORS[ERRORS_SIZE] = {
     "Error (Bit 31)",                            // 1000 0000 0000 0000 0000 0000 0000 0000 (32)
 };
 
-void SolaxX1Mini::on_solax_modbus_data(const uint8_t &function, const std::vector<uint8_t> &data) {
+static const char *const MODE_NAME_UNKNOWN = "Unknown";
+static const char *const MODE_NAME_OFFLINE = "Offline";
+
+// All errors joined by ";" plus the terminating null
+static constexpr size_t errors_text_size() {
+  size_t size = 0;
+  for (const char *error : ERRORS)
+    size += std::char_traits<char>::length(error) + 1;
+  return size;
+}
+static const size_t ERRORS_TEXT_SIZE = errors_text_size();
+
+enum RegisterType : uint8_t {
+  REGISTER_BYTE,
+  REGISTER_U8,      // low byte of a 16 bit register
+  REGISTER_U16,
+  REGISTER_S16,
+  REGISTER_U32,
+  REGISTER_U32_LE,  // little-endian bitmask
+};
+
+struct StatusRegister {
+  uint8_t offset;
+  RegisterType type;
+  float scale;
+  StatusSensorSlot slot;
+  bool skip_zero;
+};
+
+static const uint8_t STATUS_REGISTER_TEMPERATURE = 0;
+static const uint8_t STATUS_REGISTER_DC1_VOLTAGE = 4;
+static const uint8_t STATUS_REGISTER_DC2_VOLTAGE = 6;
+static const uint8_t STATUS_REGISTER_DC1_CURRENT = 8;
+static const uint8_t STATUS_REGISTER_DC2_CURRENT = 10;
+static const uint8_t STATUS_REGISTER_AC_CURRENT = 12;
+static const uint8_t STATUS_REGISTER_AC_VOLTAGE = 14;
+static const uint8_t STATUS_REGISTER_AC_POWER = 18;
+static const uint8_t STATUS_REGISTER_MODE = 30;
+static const uint8_t STATUS_REGISTER_ERROR_BITS = 46;
+static const uint8_t STATUS_REGISTER_CT_POWER = 50;
+
+// Status report registers shared by all generations (offsets relative to the payload)
+static constexpr StatusRegister STATUS_REGISTERS[] = {
+    {STATUS_REGISTER_TEMPERATURE, REGISTER_S16, 1.0f, SLOT_TEMPERATURE, false},
+    {2, REGISTER_U16, 0.1f, SLOT_ENERGY_TODAY, false},
+    {STATUS_REGISTER_DC1_VOLTAGE, REGISTER_U16, 0.1f, SLOT_DC1_VOLTAGE, false},
+    {STATUS_REGISTER_DC2_VOLTAGE, REGISTER_U16, 0.1f, SLOT_DC2_VOLTAGE, false},
+    {STATUS_REGISTER_DC1_CURRENT, REGISTER_U16, 0.1f, SLOT_DC1_CURRENT, false},
+    {STATUS_REGISTER_DC2_CURRENT, REGISTER_U16, 0.1f, SLOT_DC2_CURRENT, false},
+    {STATUS_REGISTER_AC_CURRENT, REGISTER_U16, 0.1f, SLOT_AC_CURRENT, false},
+    {STATUS_REGISTER_AC_VOLTAGE, REGISTER_U16, 0.1f, SLOT_AC_VOLTAGE, false},
+    {16, REGISTER_U16, 0.01f, SLOT_AC_FREQUENCY, false},
+    {STATUS_REGISTER_AC_POWER, REGISTER_U16, 1.0f, SLOT_AC_POWER, false},
+    // register 20 is not used
+    {22, REGISTER_U32, 0.1f, SLOT_ENERGY_TOTAL, true},
+    {26, REGISTER_U32, 1.0f, SLOT_RUNTIME_TOTAL, true},
+    {STATUS_REGISTER_MODE, REGISTER_U8, 1.0f, SLOT_MODE, false},
+    {32, REGISTER_U16, 0.1f, SLOT_GRID_VOLTAGE_FAULT, false},
+    {34, REGISTER_U16, 0.01f, SLOT_GRID_FREQUENCY_FAULT, false},
+    {36, REGISTER_U16, 0.001f, SLOT_DC_INJECTION_FAULT, false},
+    {38, REGISTER_U16, 1.0f, SLOT_TEMPERATURE_FAULT, false},
+    {40, REGISTER_U16, 0.1f, SLOT_PV1_VOLTAGE_FAULT, false},
+    {42, REGISTER_U16, 0.1f, SLOT_PV2_VOLTAGE_FAULT, false},
+    {44, REGISTER_U16, 0.001f, SLOT_GFC_FAULT, false},
+    {STATUS_REGISTER_ERROR_BITS, REGISTER_U32_LE, 1.0f, SLOT_ERROR_BITS, false},
+};
+
+struct ConfigRegister {
+  uint8_t offset;
+  RegisterType type;
+  float scale;
+  ConfigSensorSlot slot;
+};
+
+// Config settings registers exposed as sensors (offsets relative to the payload)
+static constexpr ConfigRegister CONFIG_REGISTERS[] = {
+    {0, REGISTER_U16, 0.1f, CONFIG_SLOT_PV_START_VOLTAGE},
+    {2, REGISTER_U16, 1.0f, CONFIG_SLOT_START_TIME},
+    {4, REGISTER_U16, 0.1f, CONFIG_SLOT_AC_VOLTAGE_MIN_PROTECT},
+    {6, REGISTER_U16, 0.1f, CONFIG_SLOT_AC_VOLTAGE_MAX_PROTECT},
+    {8, REGISTER_U16, 0.01f, CONFIG_SLOT_AC_FREQUENCY_MIN_PROTECT},
+    {10, REGISTER_U16, 0.01f, CONFIG_SLOT_AC_FREQUENCY_MAX_PROTECT},
+    {12, REGISTER_U16, 1.0f, CONFIG_SLOT_DCI_LIMIT},
+    {14, REGISTER_U16, 0.1f, CONFIG_SLOT_GRID_AVERAGE_VOLTAGE_PROTECT},
+    {16, REGISTER_U16, 0.1f, CONFIG_SLOT_AC_VOLTAGE_MIN_SLOW_PROTECT},
+    {18, REGISTER_U16, 0.1f, CONFIG_SLOT_AC_VOLTAGE_MAX_SLOW_PROTECT},
+    {20, REGISTER_U16, 0.01f, CONFIG_SLOT_AC_FREQUENCY_MIN_SLOW_PROTECT},
+    {22, REGISTER_U16, 0.01f, CONFIG_SLOT_AC_FREQUENCY_MAX_SLOW_PROTECT},
+    {24, REGISTER_U16, 1.0f, CONFIG_SLOT_SAFETY},
+    {26, REGISTER_BYTE, 1.0f, CONFIG_SLOT_POWER_FACTOR_MODE},
+    {42, REGISTER_U16, 1.0f, CONFIG_SLOT_POWER_LIMIT},
+};
+
+struct StatusReportLayout {
+  uint8_t length;
+  const char *generation;
+  bool has_ct_power;
+};
+
+static constexpr StatusReportLayout STATUS_REPORT_LAYOUTS[] = {
+    {50, "G2", false},
+    {52, "G1", true},
+    {56, "G3", true},
+};
+
+static uint16_t solax_get_16bit(const uint8_t *data, size_t i) {
+  return (uint16_t(data[i + 0]) << 8) | (uint16_t(data[i + 1]) << 0);
+}
+
+static uint32_t solax_get_32bit(const uint8_t *data, size_t i) {
+  return uint32_t((data[i] << 24) | (data[i + 1] << 16) | (data[i + 2] << 8) | data[i + 3]);
+}
+
+static uint32_t solax_get_error_bitmask(const uint8_t *data, size_t i) {
+  return uint32_t((data[i + 3] << 24) | (data[i + 2] << 16) | (data[i + 1] << 8) | data[i]);
+}
+
+static uint32_t read_register(const uint8_t *data, uint8_t offset, RegisterType type) {
+  switch (type) {
+    case REGISTER_BYTE:
+      return data[offset];
+    case REGISTER_U8:
+      return data[offset + 1];
+    case REGISTER_U16:
+    case REGISTER_S16:
+      return solax_get_16bit(data, offset);
+    case REGISTER_U32:
+      return solax_get_32bit(data, offset);
+    case REGISTER_U32_LE:
+      return solax_get_error_bitmask(data, offset);
+  }
+  return 0;
+}
+
+void SolaxX1Mini::on_solax_modbus_data(const uint8_t &function, const uint8_t *data, size_t len) {
   switch (function) {
     case FUNCTION_DEVICE_INFO:
-      this->decode_device_info_(data);
+      this->decode_device_info_(data, len);
       break;
     case FUNCTION_STATUS_REPORT:
-      this->decode_status_report_(data);
+      this->decode_status_report_(data, len);
       break;
     case FUNCTION_CONFIG_SETTINGS:
-      this->decode_config_settings_(data);
+      this->decode_config_settings_(data, len);
       break;
     default:
-      ESP_LOGW(TAG, "Unhandled solax frame: %s", format_hex_pretty(&data.front(), data.size()).c_str());  // NOLINT
+      ESP_LOGW(TAG, "Unhandled solax frame: %s", format_hex_pretty(data, len).c_str());  // NOLINT
   }
 }
 
-void SolaxX1Mini::decode_device_info_(const std::vector<uint8_t> &data) {
-  if (data.size() != 58) {
-    ESP_LOGW(TAG, "Invalid response size: %zu", data.size());
+void SolaxX1Mini::decode_device_info_(const uint8_t *data, size_t len) {
+  if (len != 58) {
+    ESP_LOGW(TAG, "Invalid response size: %zu", len);
     return;
   }
 
   ESP_LOGI(TAG, "Device info frame received");
   ESP_LOGI(TAG, "  Device type: %d", data[0]);
-  ESP_LOGI(TAG, "  Rated power: %s", std::string(data.begin() + 1, data.begin() + 1 + 6).c_str());
-  ESP_LOGI(TAG, "  Firmware version: %s", std::string(data.begin() + 7, data.begin() + 7 + 5).c_str());
-  ESP_LOGI(TAG, "  Module name: %s", std::string(data.begin() + 12, data.begin() + 12 + 14).c_str());
-  ESP_LOGI(TAG, "  Manufacturer: %s", std::string(data.begin() + 26, data.begin() + 26 + 14).c_str());
-  ESP_LOGI(TAG, "  Serial number: %s", std::string(data.begin() + 40, data.begin() + 40 + 14).c_str());
-  ESP_LOGI(TAG, "  Rated bus voltage: %s", std::string(data.begin() + 54, data.begin() + 54 + 4).c_str());
+  ESP_LOGI(TAG, "  Rated power: %.*s", 6, (const char *) data + 1);
+  ESP_LOGI(TAG, "  Firmware version: %.*s", 5, (const char *) data + 7);
+  ESP_LOGI(TAG, "  Module name: %.*s", 14, (const char *) data + 12);
+  ESP_LOGI(TAG, "  Manufacturer: %.*s", 14, (const char *) data + 26);
+  ESP_LOGI(TAG, "  Serial number: %.*s", 14, (const char *) data + 40);
+  ESP_LOGI(TAG, "  Rated bus voltage: %.*s", 4, (const char *) data + 54);
 
   this->no_response_count_ = 0;
 }
 
-void SolaxX1Mini::decode_config_settings_(const std::vector<uint8_t> &data) {
-  if (data.size() != 68) {
-    ESP_LOGW(TAG, "Invalid response size: %zu", data.size());
+void SolaxX1Mini::decode_config_settings_(const uint8_t *data, size_t len) {
+  if (len != CONFIG_SETTINGS_SIZE) {
+    ESP_LOGW(TAG, "Invalid response size: %zu", len);
     return;
   }
 
-  auto solax_get_16bit = [&](size_t i) -> uint16_t {
-    return (uint16_t(data[i + 0]) << 8) | (uint16_t(data[i + 1]) << 0);
-  };
+  this->no_response_count_ = 0;
+  this->config_settings_pending_ = false;
+  this->last_config_settings_ = millis();
+
+  // The settings hardly ever change: nothing to decode if the frame is the same as last time
+  if (this->config_settings_.valid && memcmp(this->config_settings_.frame, data, len) == 0) {
+    ESP_LOGD(TAG, "Config settings unchanged");
+    return;
+  }
+
+  memcpy(this->config_settings_.frame, data, len);
+  for (const auto &reg : CONFIG_REGISTERS) {
+    float value = read_register(data, reg.offset, reg.type) * reg.scale;
+    this->config_settings_.values[reg.slot] = value;
+    this->publish_state_(this->config_sensors_[reg.slot], value);
+  }
+  this->config_settings_.valid = true;
 
   ESP_LOGI(TAG, "Config settings frame received");
-  ESP_LOGI(TAG, "  wVpvStart [9.10]: %f V", solax_get_16bit(0) * 0.1f);
-  ESP_LOGI(TAG, "  wTimeStart [11.12]: %d S", solax_get_16bit(2));
-  ESP_LOGI(TAG, "  wVacMinProtect [13.14]: %f V", solax_get_16bit(4) * 0.1f);
-  ESP_LOGI(TAG, "  wVacMaxProtect [15.16]: %f V", solax_get_16bit(6) * 0.1f);
-  ESP_LOGI(TAG, "  wFacMinProtect [17.18]: %f Hz", solax_get_16bit(8) * 0.01f);
-  ESP_LOGI(TAG, "  wFacMaxProtect [19.20]: %f Hz", solax_get_16bit(10) * 0.01f);
-  ESP_LOGI(TAG, "  wDciLimits [21.22]: %d mA", solax_get_16bit(12));
-  ESP_LOGI(TAG, "  wGrid10MinAvgProtect [23,24]: %f V", solax_get_16bit(14) * 0.1f);
-  ESP_LOGI(TAG, "  wVacMinSlowProtect [25.26]: %f V", solax_get_16bit(16) * 0.1f);
-  ESP_LOGI(TAG, "  wVacMaxSlowProtect [27.28]: %f V", solax_get_16bit(18) * 0.1f);
-  ESP_LOGI(TAG, "  wFacMinSlowProtect [29.30]: %f Hz", solax_get_16bit(20) * 0.01f);
-  ESP_LOGI(TAG, "  wFacMaxSlowProtect [31.32]: %f Hz", solax_get_16bit(22) * 0.01f);
-  ESP_LOGI(TAG, "  wSafety [33.34]: %d", solax_get_16bit(24));
+  ESP_LOGI(TAG, "  wVpvStart [9.10]: %f V", solax_get_16bit(data, 0) * 0.1f);
+  ESP_LOGI(TAG, "  wTimeStart [11.12]: %d S", solax_get_16bit(data, 2));
+  ESP_LOGI(TAG, "  wVacMinProtect [13.14]: %f V", solax_get_16bit(data, 4) * 0.1f);
+  ESP_LOGI(TAG, "  wVacMaxProtect [15.16]: %f V", solax_get_16bit(data, 6) * 0.1f);
+  ESP_LOGI(TAG, "  wFacMinProtect [17.18]: %f Hz", solax_get_16bit(data, 8) * 0.01f);
+  ESP_LOGI(TAG, "  wFacMaxProtect [19.20]: %f Hz", solax_get_16bit(data, 10) * 0.01f);
+  ESP_LOGI(TAG, "  wDciLimits [21.22]: %d mA", solax_get_16bit(data, 12));
+  ESP_LOGI(TAG, "  wGrid10MinAvgProtect [23,24]: %f V", solax_get_16bit(data, 14) * 0.1f);
+  ESP_LOGI(TAG, "  wVacMinSlowProtect [25.26]: %f V", solax_get_16bit(data, 16) * 0.1f);
+  ESP_LOGI(TAG, "  wVacMaxSlowProtect [27.28]: %f V", solax_get_16bit(data, 18) * 0.1f);
+  ESP_LOGI(TAG, "  wFacMinSlowProtect [29.30]: %f Hz", solax_get_16bit(data, 20) * 0.01f);
+  ESP_LOGI(TAG, "  wFacMaxSlowProtect [31.32]: %f Hz", solax_get_16bit(data, 22) * 0.01f);
+  ESP_LOGI(TAG, "  wSafety [33.34]: %d", solax_get_16bit(data, 24));
   // Supported safety values:
   //
   // 0: VDE0126
@@ -167,30 +321,45 @@ void SolaxX1Mini::decode_config_settings_(const std::vector<uint8_t> &data) {
   ESP_LOGI(TAG, "  wLowerLimit [38]: %d", data[29]);
   ESP_LOGI(TAG, "  wPowerLow [39]: %d", data[30]);
   ESP_LOGI(TAG, "  wPowerUp [40]: %d", data[31]);
-  ESP_LOGI(TAG, "  Qpower_set [41.42]: %d", solax_get_16bit(32));
-  ESP_LOGI(TAG, "  WFreqSetPoint [43.44]: %f Hz", solax_get_16bit(34) * 0.01f);
-  ESP_LOGI(TAG, "  WFreqDropRate [45.46]: %d", solax_get_16bit(36));
-  ESP_LOGI(TAG, "  QuVupRate [47.48]: %d", solax_get_16bit(38));
-  ESP_LOGI(TAG, "  QuVlowRate [49.50]: %d", solax_get_16bit(40));
-  ESP_LOGI(TAG, "  WPowerLimitsPercent [51.52]: %d", solax_get_16bit(42));
-  ESP_LOGI(TAG, "  WWgra [53.54]: %f %%", solax_get_16bit(44) * 0.01f);
-  ESP_LOGI(TAG, "  wWv2 [55.56]: %f V", solax_get_16bit(46) * 0.1f);
-  ESP_LOGI(TAG, "  wWv3 [57.58]: %f V", solax_get_16bit(48) * 0.1f);
-  ESP_LOGI(TAG, "  wWv4 [59.60]: %f V", solax_get_16bit(50) * 0.1f);
-  ESP_LOGI(TAG, "  wQurangeV1 [61.62]: %d %%", solax_get_16bit(52));
-  ESP_LOGI(TAG, "  wQurangeV4 [63.64]: %d %%", solax_get_16bit(54));
-  ESP_LOGI(TAG, "  BVoltPowerLimit [65.66]: %d", solax_get_16bit(56));
-  ESP_LOGI(TAG, "  WPowerManagerEnable [67.68]: %d", solax_get_16bit(58));
-  ESP_LOGI(TAG, "  WGlobalSearchMPPTStartFlag [69.70]: %d", solax_get_16bit(60));
-  ESP_LOGI(TAG, "  WFreqProtectRestrictive [71.72]: %d", solax_get_16bit(62));
-  ESP_LOGI(TAG, "  WQuDelayTimer [73.74]: %d S", solax_get_16bit(64));
-  ESP_LOGI(TAG, "  WFreqActivePowerDelayTimer [75.76]: %d ms", solax_get_16bit(66));
+  ESP_LOGI(TAG, "  Qpower_set [41.42]: %d", solax_get_16bit(data, 32));
+  ESP_LOGI(TAG, "  WFreqSetPoint [43.44]: %f Hz", solax_get_16bit(data, 34) * 0.01f);
+  ESP_LOGI(TAG, "  WFreqDropRate [45.46]: %d", solax_get_16bit(data, 36));
+  ESP_LOGI(TAG, "  QuVupRate [47.48]: %d", solax_get_16bit(data, 38));
+  ESP_LOGI(TAG, "  QuVlowRate [49.50]: %d", solax_get_16bit(data, 40));
+  ESP_LOGI(TAG, "  WPowerLimitsPercent [51.52]: %d", solax_get_16bit(data, 42));
+  ESP_LOGI(TAG, "  WWgra [53.54]: %f %%", solax_get_16bit(data, 44) * 0.01f);
+  ESP_LOGI(TAG, "  wWv2 [55.56]: %f V", solax_get_16bit(data, 46) * 0.1f);
+  ESP_LOGI(TAG, "  wWv3 [57.58]: %f V", solax_get_16bit(data, 48) * 0.1f);
+  ESP_LOGI(TAG, "  wWv4 [59.60]: %f V", solax_get_16bit(data, 50) * 0.1f);
+  ESP_LOGI(TAG, "  wQurangeV1 [61.62]: %d %%", solax_get_16bit(data, 52));
+  ESP_LOGI(TAG, "  wQurangeV4 [63.64]: %d %%", solax_get_16bit(data, 54));
+  ESP_LOGI(TAG, "  BVoltPowerLimit [65.66]: %d", solax_get_16bit(data, 56));
+  ESP_LOGI(TAG, "  WPowerManagerEnable [67.68]: %d", solax_get_16bit(data, 58));
+  ESP_LOGI(TAG, "  WGlobalSearchMPPTStartFlag [69.70]: %d", solax_get_16bit(data, 60));
+  ESP_LOGI(TAG, "  WFreqProtectRestrictive [71.72]: %d", solax_get_16bit(data, 62));
+  ESP_LOGI(TAG, "  WQuDelayTimer [73.74]: %d S", solax_get_16bit(data, 64));
+  ESP_LOGI(TAG, "  WFreqActivePowerDelayTimer [75.76]: %d ms", solax_get_16bit(data, 66));
+}
 
-  this->no_response_count_ = 0;
+bool SolaxX1Mini::config_settings_due_(uint32_t now) const {
+  bool has_sensors = std::any_of(std::begin(this->config_sensors_), std::end(this->config_sensors_),
+                                 [](const sensor::Sensor *sensor) { return sensor != nullptr; });
+  if (!has_sensors)
+    return false;
+
+  return this->config_settings_pending_ || now - this->last_config_settings_ >= this->config_settings_interval_;
 }
 
-void SolaxX1Mini::decode_status_report_(const std::vector<uint8_t> &data) {
-  if (data.size() != 52 && data.size() != 50 && data.size() != 56) {
+void SolaxX1Mini::decode_status_report_(const uint8_t *data, size_t len) {
+  const StatusReportLayout *layout = nullptr;
+  for (const auto &candidate : STATUS_REPORT_LAYOUTS) {
+    if (candidate.length == len) {
+      layout = &candidate;
+      break;
+    }
+  }
+
+  if (layout == nullptr) {
     // Solax X1 mini status report (data_len 0x34: 52 bytes):
     // AA.55.00.0A.01.00.11.82.34.00.1A.00.02.00.00.00.00.00.00.00.00.00.00.09.21.13.87.00.00.FF.FF.
     // 00.00.00.12.00.00.00.15.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.04.D6
@@ -202,96 +371,145 @@ void SolaxX1Mini::decode_status_report_(const std::vector<uint8_t> &data) {
     // Solax X1 mini g3 status report (data_len 0x38: 56 bytes):
     // AA.55.00.0A.01.00.11.82.38.00.1A.00.03.04.0C.00.00.00.19.00.00.00.0B.08.FC.13.8A.00.F8.FF.FF.
     // 00.00.00.2B.00.00.00.0D.00.02.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.00.8A.00.DE.08.5F
-    ESP_LOGW(TAG, "Invalid response size: %zu", data.size());
+    ESP_LOGW(TAG, "Invalid response size: %zu", len);
     ESP_LOGW(TAG, "Your device is probably not supported. Please create an issue here: "
                   "https://github.com/syssi/esphome-solax-x1-mini/issues");
     ESP_LOGW(TAG, "Please provide the following status response data: %s",
-             format_hex_pretty(&data.front(), data.size()).c_str());  // NOLINT
+             format_hex_pretty(data, len).c_str());  // NOLINT
     return;
   }
 
-  auto solax_get_16bit = [&](size_t i) -> uint16_t {
-    return (uint16_t(data[i + 0]) << 8) | (uint16_t(data[i + 1]) << 0);
-  };
-  auto solax_get_32bit = [&](size_t i) -> uint32_t {
-    return uint32_t((data[i] << 24) | (data[i + 1] << 16) | (data[i + 2] << 8) | data[i + 3]);
-  };
-  auto solax_get_error_bitmask = [&](size_t i) -> uint32_t {
-    return uint32_t((data[i + 3] << 24) | (data[i + 2] << 16) | (data[i + 1] << 8) | data[i]);
-  };
-
-  ESP_LOGI(TAG, "Status frame received");
-
-  this->publish_state_(this->temperature_sensor_, (int16_t) solax_get_16bit(0));
-  this->publish_state_(this->energy_today_sensor_, solax_get_16bit(2) * 0.1f);
-  this->publish_state_(this->dc1_voltage_sensor_, solax_get_16bit(4) * 0.1f);
-  this->publish_state_(this->dc2_voltage_sensor_, solax_get_16bit(6) * 0.1f);
-  this->publish_state_(this->dc1_current_sensor_, solax_get_16bit(8) * 0.1f);
-  this->publish_state_(this->dc2_current_sensor_, solax_get_16bit(10) * 0.1f);
-  this->publish_state_(this->ac_current_sensor_, solax_get_16bit(12) * 0.1f);
-  this->publish_state_(this->ac_voltage_sensor_, solax_get_16bit(14) * 0.1f);
-  this->publish_state_(this->ac_frequency_sensor_, solax_get_16bit(16) * 0.01f);
-  this->publish_state_(this->ac_power_sensor_, solax_get_16bit(18));
-
-  // register 20 is not used
-
-  uint32_t raw_energy_total = solax_get_32bit(22);
-  // The inverter publishes a zero once per day on boot-up. This confuses the energy dashboard.
-  if (raw_energy_total > 0) {
-    this->publish_state_(this->energy_total_sensor_, raw_energy_total * 0.1f);
+  ESP_LOGI(TAG, "Status frame received (%s)", layout->generation);
+
+  for (const auto &reg : STATUS_REGISTERS) {
+    uint32_t raw = read_register(data, reg.offset, reg.type);
+    // The inverter publishes a zero energy/runtime total once per day on boot-up. This confuses the energy dashboard.
+    if (reg.skip_zero && raw == 0)
+      continue;
+
+    float value = (reg.type == REGISTER_S16) ? (int16_t) raw * reg.scale : raw * reg.scale;
+    this->publish_register_(reg.slot, this->status_sensors_[reg.slot], raw, value);
   }
 
-  uint32_t raw_runtime_total = solax_get_32bit(26);
-  if (raw_runtime_total > 0) {
-    this->publish_state_(this->runtime_total_sensor_, (float) raw_runtime_total);
+  uint8_t mode = data[STATUS_REGISTER_MODE + 1];
+  this->publish_mode_name_((mode < MODES_SIZE) ? MODES[mode] : MODE_NAME_UNKNOWN);
+  this->publish_errors_(solax_get_error_bitmask(data, STATUS_REGISTER_ERROR_BITS));
+
+  if (layout->has_ct_power) {
+    ESP_LOGD(TAG, "  CT Pgrid: %d W", solax_get_16bit(data, STATUS_REGISTER_CT_POWER));
   }
 
-  uint8_t mode = (uint8_t) solax_get_16bit(30);
-  this->publish_state_(this->mode_sensor_, mode);
-  this->publish_state_(this->mode_name_text_sensor_, (mode < MODES_SIZE) ? MODES[mode] : "Unknown");
+  this->record_history_(data);
 
-  this->publish_state_(this->grid_voltage_fault_sensor_, solax_get_16bit(32) * 0.1f);
-  this->publish_state_(this->grid_frequency_fault_sensor_, solax_get_16bit(34) * 0.01f);
-  this->publish_state_(this->dc_injection_fault_sensor_, solax_get_16bit(36) * 0.001f);
-  this->publish_state_(this->temperature_fault_sensor_, (float) solax_get_16bit(38));
-  this->publish_state_(this->pv1_voltage_fault_sensor_, solax_get_16bit(40) * 0.1f);
-  this->publish_state_(this->pv2_voltage_fault_sensor_, solax_get_16bit(42) * 0.1f);
-  this->publish_state_(this->gfc_fault_sensor_, solax_get_16bit(44) * 0.001f);
+  this->no_response_count_ = 0;
+  this->adapt_update_interval_(mode == MODE_WAIT, solax_get_16bit(data, STATUS_REGISTER_AC_POWER));
+}
+
+void SolaxX1Mini::record_history_(const uint8_t *data) {
+  if (this->history_.get_capacity() == 0)
+    return;
 
-  uint32_t error_bits = solax_get_error_bitmask(46);
-  this->publish_state_(this->error_bits_sensor_, error_bits);
-  this->publish_state_(this->errors_text_sensor_, this->error_bits_to_string_(error_bits));
+  StatusSample sample;
+  sample.timestamp = millis();
+  sample.error_bits = solax_get_error_bitmask(data, STATUS_REGISTER_ERROR_BITS);
+  sample.ac_power = solax_get_16bit(data, STATUS_REGISTER_AC_POWER);
+  sample.ac_voltage = solax_get_16bit(data, STATUS_REGISTER_AC_VOLTAGE);
+  sample.ac_current = solax_get_16bit(data, STATUS_REGISTER_AC_CURRENT);
+  sample.dc1_voltage = solax_get_16bit(data, STATUS_REGISTER_DC1_VOLTAGE);
+  sample.dc2_voltage = solax_get_16bit(data, STATUS_REGISTER_DC2_VOLTAGE);
+  sample.dc1_current = std::min<uint16_t>(solax_get_16bit(data, STATUS_REGISTER_DC1_CURRENT), UINT8_MAX);
+  sample.dc2_current = std::min<uint16_t>(solax_get_16bit(data, STATUS_REGISTER_DC2_CURRENT), UINT8_MAX);
+  sample.temperature = std::clamp<int16_t>(solax_get_16bit(data, STATUS_REGISTER_TEMPERATURE), INT8_MIN, INT8_MAX);
+  sample.mode = data[STATUS_REGISTER_MODE + 1];
+  this->history_.push(sample);
+}
 
-  if (data.size() > 50) {
-    ESP_LOGD(TAG, "  CT Pgrid: %d W", solax_get_16bit(50));
+void SolaxX1Mini::publish_device_offline_() {
+  // Publish the next status report unconditionally
+  for (auto &published : this->published_registers_) {
+    published.valid = false;
   }
+  this->errors_published_ = false;
+
+  this->publish_state_(this->status_sensors_[SLOT_MODE], -1);
+  this->publish_mode_name_(MODE_NAME_OFFLINE);
+
+  this->publish_state_(this->status_sensors_[SLOT_TEMPERATURE], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_DC1_VOLTAGE], 0);
+  this->publish_state_(this->status_sensors_[SLOT_DC2_VOLTAGE], 0);
+  this->publish_state_(this->status_sensors_[SLOT_DC1_CURRENT], 0);
+  this->publish_state_(this->status_sensors_[SLOT_DC2_CURRENT], 0);
+  this->publish_state_(this->status_sensors_[SLOT_AC_CURRENT], 0);
+  this->publish_state_(this->status_sensors_[SLOT_AC_VOLTAGE], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_AC_FREQUENCY], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_AC_POWER], 0);
+  this->publish_state_(this->status_sensors_[SLOT_GRID_VOLTAGE_FAULT], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_GRID_FREQUENCY_FAULT], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_DC_INJECTION_FAULT], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_TEMPERATURE_FAULT], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_PV1_VOLTAGE_FAULT], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_PV2_VOLTAGE_FAULT], NAN);
+  this->publish_state_(this->status_sensors_[SLOT_GFC_FAULT], NAN);
+
+  // Forget the last power reading, the drop to zero is not a transient worth polling fast for
+  this->adapt_update_interval_(true, NAN);
+}
 
-  this->no_response_count_ = 0;
+void SolaxX1Mini::adapt_update_interval_(bool idle, float ac_power) {
+  if (!this->adaptive_polling_)
+    return;
+
+  if (this->base_update_interval_ == 0) {
+    this->base_update_interval_ = this->get_update_interval();
+  }
+
+  uint32_t interval = this->get_update_interval();
+  bool power_changed = !idle && !std::isnan(this->last_ac_power_) &&
+                       std::fabs(ac_power - this->last_ac_power_) >= this->power_change_threshold_;
+  this->last_ac_power_ = ac_power;
+
+  if (power_changed) {
+    // Fast transient (clouds): poll as fast as allowed
+    interval = this->min_update_interval_;
+  } else if (idle) {
+    // Wait mode or offline (night): back off up to the maximum interval
+    interval = std::min(interval * 2, this->max_update_interval_);
+  } else if (interval > this->base_update_interval_) {
+    interval = this->base_update_interval_;
+  } else {
+    // Flat power: back off towards the configured update interval
+    interval = std::min(interval * 2, this->base_update_interval_);
+  }
+
+  if (interval == this->get_update_interval())
+    return;
+
+  ESP_LOGD(TAG, "Changing update interval from %u ms to %u ms", (unsigned) this->get_update_interval(),
+           (unsigned) interval);
+  this->set_update_interval(interval);
+  this->stop_poller();
+  this->start_poller();
 }
 
-void SolaxX1Mini::publish_device_offline_() {
-  this->publish_state_(this->mode_sensor_, -1);
-  this->publish_state_(this->mode_name_text_sensor_, "Offline");
-
-  this->publish_state_(this->temperature_sensor_, NAN);
-  this->publish_state_(this->dc1_voltage_sensor_, 0);
-  this->publish_state_(this->dc2_voltage_sensor_, 0);
-  this->publish_state_(this->dc1_current_sensor_, 0);
-  this->publish_state_(this->dc2_current_sensor_, 0);
-  this->publish_state_(this->ac_current_sensor_, 0);
-  this->publish_state_(this->ac_voltage_sensor_, NAN);
-  this->publish_state_(this->ac_frequency_sensor_, NAN);
-  this->publish_state_(this->ac_power_sensor_, 0);
-  this->publish_state_(this->grid_voltage_fault_sensor_, NAN);
-  this->publish_state_(this->grid_frequency_fault_sensor_, NAN);
-  this->publish_state_(this->dc_injection_fault_sensor_, NAN);
-  this->publish_state_(this->temperature_fault_sensor_, NAN);
-  this->publish_state_(this->pv1_voltage_fault_sensor_, NAN);
-  this->publish_state_(this->pv2_voltage_fault_sensor_, NAN);
-  this->publish_state_(this->gfc_fault_sensor_, NAN);
+void SolaxX1Mini::setup() {
+  if (this->history_capacity_ == 0)
+    return;
+
+  size_t capacity = this->history_.allocate(this->history_capacity_);
+  if (capacity < this->history_capacity_) {
+    ESP_LOGW(TAG, "Not enough free heap for the history. Keeping %zu of %u samples", capacity,
+             (unsigned) this->history_capacity_);
+  }
 }
 
 void SolaxX1Mini::update() {
+  // Another master polls the inverter, only notice when its status replies stop
+  if (this->is_listen_only()) {
+    if (this->no_response_count_ < REDISCOVERY_THRESHOLD && ++this->no_response_count_ == REDISCOVERY_THRESHOLD)
+      this->publish_device_offline_();
+    return;
+  }
+
   if (this->no_response_count_ >= REDISCOVERY_THRESHOLD) {
     this->publish_device_offline_();
     ESP_LOGD(TAG, "The device is or was offline. Broadcasting discovery for address configuration...");
@@ -300,9 +518,13 @@ void SolaxX1Mini::update() {
     // Try to query live data on next update again. The device doesn't
     // respond to the discovery broadcast if it's already configured.
     this->no_response_count_ = 0;
+    // Fetch the config settings again once the device is back
+    this->config_settings_pending_ = true;
   } else {
     this->no_response_count_++;
     this->query_status_report(this->address_);
+    if (this->config_settings_due_(millis()))
+      this->query_config_settings(this->address_);
   }
 }
 
@@ -313,55 +535,119 @@ void SolaxX1Mini::publish_state_(sensor::Sensor *sensor, float value) {
   sensor->publish_state(value);
 }
 
-void SolaxX1Mini::publish_state_(text_sensor::TextSensor *text_sensor, const std::string &state) {
-  if (text_sensor == nullptr)
+void SolaxX1Mini::publish_register_(StatusSensorSlot slot, sensor::Sensor *sensor, uint32_t raw, float value) {
+  if (sensor == nullptr)
     return;
 
-  text_sensor->publish_state(state);
+  // Skip unchanged values and changes within the deadband until the next forced publish
+  PublishedRegister &published = this->published_registers_[slot];
+  if (published.valid && ++published.skipped_frames < this->publish_unchanged_every_) {
+    if (raw == published.raw)
+      return;
+    if (std::fabs(value - published.value) < published.deadband)
+      return;
+  }
+
+  sensor->publish_state(value);
+  published.raw = raw;
+  published.value = value;
+  published.skipped_frames = 0;
+  published.valid = true;
+}
+
+void SolaxX1Mini::publish_mode_name_(const char *mode_name) {
+  if (this->mode_name_text_sensor_ == nullptr || mode_name == this->published_mode_name_)
+    return;
+
+  this->mode_name_text_sensor_->publish_state(mode_name);
+  this->published_mode_name_ = mode_name;
+}
+
+void SolaxX1Mini::publish_errors_(uint32_t error_bits) {
+  if (this->errors_text_sensor_ == nullptr)
+    return;
+  if (this->errors_published_ && error_bits == this->published_error_bits_)
+    return;
+
+  char buffer[ERRORS_TEXT_SIZE];
+  this->error_bits_to_string_(error_bits, buffer, sizeof(buffer));
+  this->errors_text_sensor_->publish_state(buffer);
+  this->published_error_bits_ = error_bits;
+  this->errors_published_ = true;
 }
 
 void SolaxX1Mini::dump_config() {
   ESP_LOGCONFIG(TAG, "SolaxX1Mini:");
   ESP_LOGCONFIG(TAG, "  Address: 0x%02X", this->address_);
-  LOG_SENSOR("", "Temperature", this->temperature_sensor_);
-  LOG_SENSOR("", "Energy today", this->energy_today_sensor_);
-  LOG_SENSOR("", "DC1 voltage", this->dc1_voltage_sensor_);
-  LOG_SENSOR("", "DC2 voltage", this->dc2_voltage_sensor_);
-  LOG_SENSOR("", "DC1 current", this->dc1_current_sensor_);
-  LOG_SENSOR("", "DC2 current", this->dc2_current_sensor_);
-  LOG_SENSOR("", "AC current", this->ac_current_sensor_);
-  LOG_SENSOR("", "AC voltage", this->ac_voltage_sensor_);
-  LOG_SENSOR("", "AC frequency", this->ac_frequency_sensor_);
-  LOG_SENSOR("", "AC power", this->ac_power_sensor_);
-  LOG_SENSOR("", "Energy total", this->energy_total_sensor_);
-  LOG_SENSOR("", "Runtime total", this->runtime_total_sensor_);
-  LOG_SENSOR("", "Mode", this->mode_sensor_);
-  LOG_SENSOR("", "Error bits", this->error_bits_sensor_);
-  LOG_SENSOR("", "Grid voltage fault", this->grid_voltage_fault_sensor_);
-  LOG_SENSOR("", "Grid frequency fault", this->grid_frequency_fault_sensor_);
-  LOG_SENSOR("", "DC injection fault", this->dc_injection_fault_sensor_);
-  LOG_SENSOR("", "Temperature fault", this->temperature_fault_sensor_);
-  LOG_SENSOR("", "PV1 voltage fault", this->pv1_voltage_fault_sensor_);
-  LOG_SENSOR("", "PV2 voltage fault", this->pv2_voltage_fault_sensor_);
-  LOG_SENSOR("", "GFC fault", this->gfc_fault_sensor_);
+  ESP_LOGCONFIG(TAG, "  Publish unchanged values every: %u frames", this->publish_unchanged_every_);
+  ESP_LOGCONFIG(TAG, "  Config settings interval: %u ms", (unsigned) this->config_settings_interval_);
+  if (this->adaptive_polling_) {
+    ESP_LOGCONFIG(TAG, "  Adaptive polling: %u ms ... %u ms, power change threshold: %.0f W",
+                  (unsigned) this->min_update_interval_, (unsigned) this->max_update_interval_,
+                  this->power_change_threshold_);
+  }
+  if (this->history_capacity_ > 0) {
+    ESP_LOGCONFIG(TAG, "  History: %zu samples (%zu bytes)", this->history_.get_capacity(),
+                  this->history_.get_capacity() * sizeof(StatusSample));
+  }
+  LOG_SENSOR("", "Temperature", this->status_sensors_[SLOT_TEMPERATURE]);
+  LOG_SENSOR("", "Energy today", this->status_sensors_[SLOT_ENERGY_TODAY]);
+  LOG_SENSOR("", "DC1 voltage", this->status_sensors_[SLOT_DC1_VOLTAGE]);
+  LOG_SENSOR("", "DC2 voltage", this->status_sensors_[SLOT_DC2_VOLTAGE]);
+  LOG_SENSOR("", "DC1 current", this->status_sensors_[SLOT_DC1_CURRENT]);
+  LOG_SENSOR("", "DC2 current", this->status_sensors_[SLOT_DC2_CURRENT]);
+  LOG_SENSOR("", "AC current", this->status_sensors_[SLOT_AC_CURRENT]);
+  LOG_SENSOR("", "AC voltage", this->status_sensors_[SLOT_AC_VOLTAGE]);
+  LOG_SENSOR("", "AC frequency", this->status_sensors_[SLOT_AC_FREQUENCY]);
+  LOG_SENSOR("", "AC power", this->status_sensors_[SLOT_AC_POWER]);
+  LOG_SENSOR("", "Energy total", this->status_sensors_[SLOT_ENERGY_TOTAL]);
+  LOG_SENSOR("", "Runtime total", this->status_sensors_[SLOT_RUNTIME_TOTAL]);
+  LOG_SENSOR("", "Mode", this->status_sensors_[SLOT_MODE]);
+  LOG_SENSOR("", "Error bits", this->status_sensors_[SLOT_ERROR_BITS]);
+  LOG_SENSOR("", "Grid voltage fault", this->status_sensors_[SLOT_GRID_VOLTAGE_FAULT]);
+  LOG_SENSOR("", "Grid frequency fault", this->status_sensors_[SLOT_GRID_FREQUENCY_FAULT]);
+  LOG_SENSOR("", "DC injection fault", this->status_sensors_[SLOT_DC_INJECTION_FAULT]);
+  LOG_SENSOR("", "Temperature fault", this->status_sensors_[SLOT_TEMPERATURE_FAULT]);
+  LOG_SENSOR("", "PV1 voltage fault", this->status_sensors_[SLOT_PV1_VOLTAGE_FAULT]);
+  LOG_SENSOR("", "PV2 voltage fault", this->status_sensors_[SLOT_PV2_VOLTAGE_FAULT]);
+  LOG_SENSOR("", "GFC fault", this->status_sensors_[SLOT_GFC_FAULT]);
+  LOG_SENSOR("", "PV start voltage", this->config_sensors_[CONFIG_SLOT_PV_START_VOLTAGE]);
+  LOG_SENSOR("", "Start time", this->config_sensors_[CONFIG_SLOT_START_TIME]);
+  LOG_SENSOR("", "AC voltage min protect", this->config_sensors_[CONFIG_SLOT_AC_VOLTAGE_MIN_PROTECT]);
+  LOG_SENSOR("", "AC voltage max protect", this->config_sensors_[CONFIG_SLOT_AC_VOLTAGE_MAX_PROTECT]);
+  LOG_SENSOR("", "AC frequency min protect", this->config_sensors_[CONFIG_SLOT_AC_FREQUENCY_MIN_PROTECT]);
+  LOG_SENSOR("", "AC frequency max protect", this->config_sensors_[CONFIG_SLOT_AC_FREQUENCY_MAX_PROTECT]);
+  LOG_SENSOR("", "DCI limit", this->config_sensors_[CONFIG_SLOT_DCI_LIMIT]);
+  LOG_SENSOR("", "Grid average voltage protect", this->config_sensors_[CONFIG_SLOT_GRID_AVERAGE_VOLTAGE_PROTECT]);
+  LOG_SENSOR("", "AC voltage min slow protect", this->config_sensors_[CONFIG_SLOT_AC_VOLTAGE_MIN_SLOW_PROTECT]);
+  LOG_SENSOR("", "AC voltage max slow protect", this->config_sensors_[CONFIG_SLOT_AC_VOLTAGE_MAX_SLOW_PROTECT]);
+  LOG_SENSOR("", "AC frequency min slow protect", this->config_sensors_[CONFIG_SLOT_AC_FREQUENCY_MIN_SLOW_PROTECT]);
+  LOG_SENSOR("", "AC frequency max slow protect", this->config_sensors_[CONFIG_SLOT_AC_FREQUENCY_MAX_SLOW_PROTECT]);
+  LOG_SENSOR("", "Safety", this->config_sensors_[CONFIG_SLOT_SAFETY]);
+  LOG_SENSOR("", "Power factor mode", this->config_sensors_[CONFIG_SLOT_POWER_FACTOR_MODE]);
+  LOG_SENSOR("", "Power limit", this->config_sensors_[CONFIG_SLOT_POWER_LIMIT]);
   LOG_TEXT_SENSOR("  ", "Mode name", this->mode_name_text_sensor_);
   LOG_TEXT_SENSOR("  ", "Errors", this->errors_text_sensor_);
 }
 
-std::string SolaxX1Mini::error_bits_to_string_(const uint32_t mask) {
-  std::string values;
-  if (mask) {
-    for (int i = 0; i < ERRORS_SIZE; i++) {
-      if (mask & (1 << i)) {
-        values.append(ERRORS[i]);
-        values.append(";");
-      }
-    }
-    if (!values.empty()) {
-      values.pop_back();
-    }
+size_t SolaxX1Mini::error_bits_to_string_(const uint32_t mask, char *buffer, size_t size) {
+  size_t len = 0;
+  for (int i = 0; i < ERRORS_SIZE; i++) {
+    if ((mask & (1UL << i)) == 0)
+      continue;
+
+    const char *error = ERRORS[i];
+    size_t error_len = std::char_traits<char>::length(error);
+    // Separator plus terminating null
+    if (len + error_len + 2 > size)
+      break;
+    if (len > 0)
+      buffer[len++] = ';';
+    memcpy(buffer + len, error, error_len);
+    len += error_len;
   }
-  return values;
+  buffer[len] = '\0';
+  return len;
 }
 
 }  // namespace esphome::solax_x1_mini
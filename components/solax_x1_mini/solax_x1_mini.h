@@ -4,89 +4,179 @@
 #include "esphome/components/sensor/sensor.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 #include "esphome/components/solax_modbus/solax_modbus.h"
+#include "status_history.h"
 
 namespace esphome::solax_x1_mini {
 
 static const uint8_t REDISCOVERY_THRESHOLD = 5;
 
+enum StatusSensorSlot : uint8_t {
+  SLOT_TEMPERATURE,
+  SLOT_ENERGY_TODAY,
+  SLOT_DC1_VOLTAGE,
+  SLOT_DC2_VOLTAGE,
+  SLOT_DC1_CURRENT,
+  SLOT_DC2_CURRENT,
+  SLOT_AC_CURRENT,
+  SLOT_AC_VOLTAGE,
+  SLOT_AC_FREQUENCY,
+  SLOT_AC_POWER,
+  SLOT_ENERGY_TOTAL,
+  SLOT_RUNTIME_TOTAL,
+  SLOT_MODE,
+  SLOT_GRID_VOLTAGE_FAULT,
+  SLOT_GRID_FREQUENCY_FAULT,
+  SLOT_DC_INJECTION_FAULT,
+  SLOT_TEMPERATURE_FAULT,
+  SLOT_PV1_VOLTAGE_FAULT,
+  SLOT_PV2_VOLTAGE_FAULT,
+  SLOT_GFC_FAULT,
+  SLOT_ERROR_BITS,
+  STATUS_SENSOR_SLOTS,
+};
+
+enum ConfigSensorSlot : uint8_t {
+  CONFIG_SLOT_PV_START_VOLTAGE,
+  CONFIG_SLOT_START_TIME,
+  CONFIG_SLOT_AC_VOLTAGE_MIN_PROTECT,
+  CONFIG_SLOT_AC_VOLTAGE_MAX_PROTECT,
+  CONFIG_SLOT_AC_FREQUENCY_MIN_PROTECT,
+  CONFIG_SLOT_AC_FREQUENCY_MAX_PROTECT,
+  CONFIG_SLOT_DCI_LIMIT,
+  CONFIG_SLOT_GRID_AVERAGE_VOLTAGE_PROTECT,
+  CONFIG_SLOT_AC_VOLTAGE_MIN_SLOW_PROTECT,
+  CONFIG_SLOT_AC_VOLTAGE_MAX_SLOW_PROTECT,
+  CONFIG_SLOT_AC_FREQUENCY_MIN_SLOW_PROTECT,
+  CONFIG_SLOT_AC_FREQUENCY_MAX_SLOW_PROTECT,
+  CONFIG_SLOT_SAFETY,
+  CONFIG_SLOT_POWER_FACTOR_MODE,
+  CONFIG_SLOT_POWER_LIMIT,
+  CONFIG_SENSOR_SLOTS,
+};
+
+static const uint8_t CONFIG_SETTINGS_SIZE = 68;
+
+// Last decoded config settings frame
+struct ConfigSettings {
+  uint8_t frame[CONFIG_SETTINGS_SIZE];
+  float values[CONFIG_SENSOR_SLOTS];
+  bool valid{false};
+};
+
+// Last published raw register value of a status sensor
+struct PublishedRegister {
+  uint32_t raw{0};
+  float value{0.0f};
+  float deadband{0.0f};
+  uint16_t skipped_frames{0};
+  bool valid{false};
+};
+
 class SolaxX1Mini : public PollingComponent, public solax_modbus::SolaxModbusDevice {
  public:
-  void set_energy_today_sensor(sensor::Sensor *energy_today_sensor) { energy_today_sensor_ = energy_today_sensor; }
-  void set_energy_total_sensor(sensor::Sensor *energy_total_sensor) { energy_total_sensor_ = energy_total_sensor; }
-  void set_dc1_current_sensor(sensor::Sensor *dc1_current_sensor) { dc1_current_sensor_ = dc1_current_sensor; }
-  void set_dc2_current_sensor(sensor::Sensor *dc2_current_sensor) { dc2_current_sensor_ = dc2_current_sensor; }
-  void set_dc1_voltage_sensor(sensor::Sensor *dc1_voltage_sensor) { dc1_voltage_sensor_ = dc1_voltage_sensor; }
-  void set_dc2_voltage_sensor(sensor::Sensor *dc2_voltage_sensor) { dc2_voltage_sensor_ = dc2_voltage_sensor; }
-  void set_ac_current_sensor(sensor::Sensor *ac_current_sensor) { ac_current_sensor_ = ac_current_sensor; }
-  void set_ac_frequency_sensor(sensor::Sensor *ac_frequency_sensor) { ac_frequency_sensor_ = ac_frequency_sensor; }
-  void set_ac_power_sensor(sensor::Sensor *ac_power_sensor) { ac_power_sensor_ = ac_power_sensor; }
-  void set_ac_voltage_sensor(sensor::Sensor *ac_voltage_sensor) { ac_voltage_sensor_ = ac_voltage_sensor; }
-  void set_temperature_sensor(sensor::Sensor *temperature_sensor) { temperature_sensor_ = temperature_sensor; }
-  void set_mode_sensor(sensor::Sensor *mode_sensor) { mode_sensor_ = mode_sensor; }
+  void set_energy_today_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_ENERGY_TODAY] = sensor; }
+  void set_energy_total_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_ENERGY_TOTAL] = sensor; }
+  void set_dc1_current_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_DC1_CURRENT] = sensor; }
+  void set_dc2_current_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_DC2_CURRENT] = sensor; }
+  void set_dc1_voltage_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_DC1_VOLTAGE] = sensor; }
+  void set_dc2_voltage_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_DC2_VOLTAGE] = sensor; }
+  void set_ac_current_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_AC_CURRENT] = sensor; }
+  void set_ac_frequency_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_AC_FREQUENCY] = sensor; }
+  void set_ac_power_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_AC_POWER] = sensor; }
+  void set_ac_voltage_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_AC_VOLTAGE] = sensor; }
+  void set_temperature_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_TEMPERATURE] = sensor; }
+  void set_mode_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_MODE] = sensor; }
   void set_mode_name_text_sensor(text_sensor::TextSensor *sensor) { this->mode_name_text_sensor_ = sensor; }
-  void set_error_bits_sensor(sensor::Sensor *error_bits_sensor) { error_bits_sensor_ = error_bits_sensor; }
+  void set_error_bits_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_ERROR_BITS] = sensor; }
   void set_errors_text_sensor(text_sensor::TextSensor *sensor) { this->errors_text_sensor_ = sensor; }
-  void set_runtime_total_sensor(sensor::Sensor *runtime_total_sensor) { runtime_total_sensor_ = runtime_total_sensor; }
-  void set_grid_voltage_fault_sensor(sensor::Sensor *grid_voltage_fault_sensor) {
-    grid_voltage_fault_sensor_ = grid_voltage_fault_sensor;
+  void set_runtime_total_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_RUNTIME_TOTAL] = sensor; }
+  void set_grid_voltage_fault_sensor(sensor::Sensor *sensor) {
+    this->status_sensors_[SLOT_GRID_VOLTAGE_FAULT] = sensor;
   }
-  void set_grid_frequency_fault_sensor(sensor::Sensor *grid_frequency_fault_sensor) {
-    grid_frequency_fault_sensor_ = grid_frequency_fault_sensor;
+  void set_grid_frequency_fault_sensor(sensor::Sensor *sensor) {
+    this->status_sensors_[SLOT_GRID_FREQUENCY_FAULT] = sensor;
   }
-  void set_dc_injection_fault_sensor(sensor::Sensor *dc_injection_fault_sensor) {
-    dc_injection_fault_sensor_ = dc_injection_fault_sensor;
+  void set_dc_injection_fault_sensor(sensor::Sensor *sensor) {
+    this->status_sensors_[SLOT_DC_INJECTION_FAULT] = sensor;
   }
-  void set_temperature_fault_sensor(sensor::Sensor *temperature_fault_sensor) {
-    temperature_fault_sensor_ = temperature_fault_sensor;
+  void set_temperature_fault_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_TEMPERATURE_FAULT] = sensor; }
+  void set_pv1_voltage_fault_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_PV1_VOLTAGE_FAULT] = sensor; }
+  void set_pv2_voltage_fault_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_PV2_VOLTAGE_FAULT] = sensor; }
+  void set_gfc_fault_sensor(sensor::Sensor *sensor) { this->status_sensors_[SLOT_GFC_FAULT] = sensor; }
+
+  void set_config_sensor(ConfigSensorSlot slot, sensor::Sensor *sensor) { this->config_sensors_[slot] = sensor; }
+  void set_config_settings_interval(uint32_t config_settings_interval) {
+    this->config_settings_interval_ = config_settings_interval;
   }
-  void set_pv1_voltage_fault_sensor(sensor::Sensor *pv1_voltage_fault_sensor) {
-    pv1_voltage_fault_sensor_ = pv1_voltage_fault_sensor;
+  const ConfigSettings &get_config_settings() const { return this->config_settings_; }
+
+  void set_adaptive_polling(uint32_t min_update_interval, uint32_t max_update_interval, float power_change_threshold) {
+    this->adaptive_polling_ = true;
+    this->min_update_interval_ = min_update_interval;
+    this->max_update_interval_ = max_update_interval;
+    this->power_change_threshold_ = power_change_threshold;
   }
-  void set_pv2_voltage_fault_sensor(sensor::Sensor *pv2_voltage_fault_sensor) {
-    pv2_voltage_fault_sensor_ = pv2_voltage_fault_sensor;
+
+  void set_deadband(StatusSensorSlot slot, float deadband) { this->published_registers_[slot].deadband = deadband; }
+  void set_publish_unchanged_every(uint16_t publish_unchanged_every) {
+    this->publish_unchanged_every_ = publish_unchanged_every;
   }
-  void set_gfc_fault_sensor(sensor::Sensor *gfc_fault_sensor) { gfc_fault_sensor_ = gfc_fault_sensor; }
+
+  void set_history_capacity(uint32_t history_capacity) { this->history_capacity_ = history_capacity; }
+  const StatusHistory &get_history() const { return this->history_; }
 
   uint8_t get_no_response_count() { return no_response_count_; }
 
+  void setup() override;
   void update() override;
-  void on_solax_modbus_data(const uint8_t &function, const std::vector<uint8_t> &data) override;
+  void on_solax_modbus_data(const uint8_t &function, const uint8_t *data, size_t len) override;
   void dump_config() override;
 
  protected:
-  sensor::Sensor *energy_today_sensor_{nullptr};
-  sensor::Sensor *energy_total_sensor_{nullptr};
-  sensor::Sensor *dc1_current_sensor_{nullptr};
-  sensor::Sensor *dc2_current_sensor_{nullptr};
-  sensor::Sensor *dc1_voltage_sensor_{nullptr};
-  sensor::Sensor *dc2_voltage_sensor_{nullptr};
-  sensor::Sensor *ac_current_sensor_{nullptr};
-  sensor::Sensor *ac_frequency_sensor_{nullptr};
-  sensor::Sensor *ac_power_sensor_{nullptr};
-  sensor::Sensor *ac_voltage_sensor_{nullptr};
-  sensor::Sensor *temperature_sensor_{nullptr};
-  sensor::Sensor *mode_sensor_{nullptr};
-  sensor::Sensor *error_bits_sensor_{nullptr};
-  sensor::Sensor *runtime_total_sensor_{nullptr};
-  sensor::Sensor *grid_voltage_fault_sensor_{nullptr};
-  sensor::Sensor *grid_frequency_fault_sensor_{nullptr};
-  sensor::Sensor *dc_injection_fault_sensor_{nullptr};
-  sensor::Sensor *temperature_fault_sensor_{nullptr};
-  sensor::Sensor *pv1_voltage_fault_sensor_{nullptr};
-  sensor::Sensor *pv2_voltage_fault_sensor_{nullptr};
-  sensor::Sensor *gfc_fault_sensor_{nullptr};
+  sensor::Sensor *status_sensors_[STATUS_SENSOR_SLOTS]{};
+
+  sensor::Sensor *config_sensors_[CONFIG_SENSOR_SLOTS]{};
 
   text_sensor::TextSensor *mode_name_text_sensor_{nullptr};
   text_sensor::TextSensor *errors_text_sensor_{nullptr};
   uint8_t no_response_count_ = REDISCOVERY_THRESHOLD;
 
-  void decode_device_info_(const std::vector<uint8_t> &data);
-  void decode_status_report_(const std::vector<uint8_t> &data);
-  void decode_config_settings_(const std::vector<uint8_t> &data);
+  // Text sensors are only published on changes
+  const char *published_mode_name_{nullptr};
+  uint32_t published_error_bits_{0};
+  bool errors_published_{false};
+
+  PublishedRegister published_registers_[STATUS_SENSOR_SLOTS];
+  uint16_t publish_unchanged_every_{1};
+
+  bool adaptive_polling_{false};
+  uint32_t min_update_interval_{0};
+  uint32_t max_update_interval_{0};
+  uint32_t base_update_interval_{0};
+  float power_change_threshold_{0.0f};
+  float last_ac_power_{NAN};
+
+  // The config settings are fetched once the device shows up and then only every config_settings_interval_
+  ConfigSettings config_settings_;
+  bool config_settings_pending_{true};
+  uint32_t last_config_settings_{0};
+  uint32_t config_settings_interval_{86400000};
+
+  uint32_t history_capacity_{0};
+  StatusHistory history_;
+
+  void decode_device_info_(const uint8_t *data, size_t len);
+  void decode_status_report_(const uint8_t *data, size_t len);
+  void decode_config_settings_(const uint8_t *data, size_t len);
   void publish_state_(sensor::Sensor *sensor, float value);
-  void publish_state_(text_sensor::TextSensor *text_sensor, const std::string &state);
+  void publish_register_(StatusSensorSlot slot, sensor::Sensor *sensor, uint32_t raw, float value);
+  void publish_mode_name_(const char *mode_name);
+  void publish_errors_(uint32_t error_bits);
   void publish_device_offline_();
-  std::string error_bits_to_string_(uint32_t bitmask);
+  void adapt_update_interval_(bool idle, float ac_power);
+  void record_history_(const uint8_t *data);
+  bool config_settings_due_(uint32_t now) const;
+  size_t error_bits_to_string_(uint32_t bitmask, char *buffer, size_t size);
 };
 
 }  // namespace esphome::solax_x1_mini
@@ -0,0 +1,166 @@
+#include "status_history.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/helpers.h"
+
+#ifdef USE_ESP32
+#include <esp_heap_caps.h>
+#endif
+#ifdef USE_ESP8266
+#include <Esp.h>
+#endif
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome::solax_x1_mini {
+
+static const char CSV_HEADER[] = "age_s,ac_power_w,ac_voltage_v,ac_current_a,dc1_voltage_v,dc1_current_a,dc2_voltage_v,"
+                                 "dc2_current_a,temperature_c,mode,error_bits\n";
+
+// Internal heap left to Wi-Fi, the API and the web server, which allocate after the history
+static const size_t HISTORY_HEAP_RESERVE = 24 * 1024;
+
+static size_t free_internal_heap() {
+#if defined(USE_ESP32)
+  return heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+#elif defined(USE_ESP8266)
+  return ESP.getFreeHeap();  // NOLINT(readability-static-accessed-through-instance)
+#else
+  return SIZE_MAX;
+#endif
+}
+
+size_t StatusHistory::allocate(size_t capacity) {
+  // Prefers PSRAM if available
+  RAMAllocator<StatusSample> allocator;
+  size_t allocated = 0;
+  while (allocated < capacity) {
+    size_t free_before = free_internal_heap();
+    StatusSample *block = allocator.allocate(HISTORY_BLOCK_SAMPLES);
+    if (block == nullptr)
+      break;
+    // A block in PSRAM doesn't count against the reserve
+    size_t free_after = free_internal_heap();
+    if (free_after < free_before && free_after < HISTORY_HEAP_RESERVE) {
+      allocator.deallocate(block, HISTORY_BLOCK_SAMPLES);
+      break;
+    }
+    this->blocks_.push_back(block);
+    allocated += HISTORY_BLOCK_SAMPLES;
+  }
+
+  this->capacity_ = std::min(allocated, capacity);
+  return this->capacity_;
+}
+
+void StatusHistory::push(const StatusSample &sample) {
+  if (this->capacity_ == 0)
+    return;
+
+  uint32_t sequence = this->sequence_.load(std::memory_order_relaxed);
+  // Readers copying the slot see the started push and drop their copy
+  this->writing_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  size_t index = sequence % this->capacity_;
+  this->blocks_[index / HISTORY_BLOCK_SAMPLES][index % HISTORY_BLOCK_SAMPLES] = sample;
+  this->sequence_.store(sequence + 1, std::memory_order_release);
+}
+
+const StatusSample &StatusHistory::get(uint32_t sequence) const {
+  size_t index = sequence % this->capacity_;
+  return this->blocks_[index / HISTORY_BLOCK_SAMPLES][index % HISTORY_BLOCK_SAMPLES];
+}
+
+bool StatusHistory::read(uint32_t sequence, StatusSample *sample) const {
+  uint32_t end = this->get_sequence();
+  if (end - sequence - 1 >= this->get_size(end))
+    return false;
+
+  *sample = this->get(sequence);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // The slot is reused by the push of sequence + capacity
+  return this->writing_.load(std::memory_order_relaxed) - sequence <= this->capacity_;
+}
+
+HistoryExporter::HistoryExporter(const StatusHistory *history, HistoryFormat format, uint32_t now)
+    : history_(history), format_(format), now_(now) {
+  this->end_sequence_ = history->get_sequence();
+  this->next_sequence_ = this->end_sequence_ - history->get_size(this->end_sequence_);
+}
+
+size_t HistoryExporter::read(uint8_t *buffer, size_t size) {
+  size_t len = 0;
+  while (len < size) {
+    if (this->chunk_pos_ == this->chunk_len_ && !this->next_chunk_())
+      break;
+
+    size_t chunk = std::min(size - len, this->chunk_len_ - this->chunk_pos_);
+    memcpy(buffer + len, this->chunk_ + this->chunk_pos_, chunk);
+    this->chunk_pos_ += chunk;
+    len += chunk;
+  }
+  return len;
+}
+
+bool HistoryExporter::next_chunk_() {
+  this->chunk_pos_ = 0;
+  this->chunk_len_ = 0;
+
+  if (!this->header_sent_) {
+    this->header_sent_ = true;
+    if (this->format_ == HISTORY_FORMAT_BINARY) {
+      const uint8_t header[HISTORY_BINARY_HEADER_SIZE] = {
+          'S',
+          'X',
+          'H',
+          HISTORY_BINARY_VERSION,
+          uint8_t(this->now_ >> 0),
+          uint8_t(this->now_ >> 8),
+          uint8_t(this->now_ >> 16),
+          uint8_t(this->now_ >> 24),
+      };
+      memcpy(this->chunk_, header, sizeof(header));
+      this->chunk_len_ = sizeof(header);
+    } else {
+      memcpy(this->chunk_, CSV_HEADER, sizeof(CSV_HEADER) - 1);
+      this->chunk_len_ = sizeof(CSV_HEADER) - 1;
+    }
+    return true;
+  }
+
+  // The main loop keeps pushing samples while the web server task exports them
+  StatusSample sample;
+  while (true) {
+    if (int32_t(this->end_sequence_ - this->next_sequence_) <= 0)
+      return false;
+    if (this->history_->read(this->next_sequence_, &sample))
+      break;
+
+    // Overwritten since the export started, go on with the oldest sample still stored
+    uint32_t sequence = this->history_->get_sequence();
+    uint32_t oldest = sequence - this->history_->get_size(sequence);
+    this->next_sequence_ = int32_t(oldest - this->next_sequence_) > 0 ? oldest : this->next_sequence_ + 1;
+  }
+  this->next_sequence_++;
+
+  if (this->format_ == HISTORY_FORMAT_BINARY) {
+    memcpy(this->chunk_, &sample, sizeof(sample));
+    this->chunk_len_ = sizeof(sample);
+    return true;
+  }
+
+  int len = snprintf(this->chunk_, sizeof(this->chunk_),
+                     "%" PRIu32 ",%u,%u.%u,%u.%u,%u.%u,%u.%u,%u.%u,%u.%u,%d,%u,0x%08" PRIX32 "\n",
+                     (this->now_ - sample.timestamp) / 1000, sample.ac_power, sample.ac_voltage / 10,
+                     sample.ac_voltage % 10, sample.ac_current / 10, sample.ac_current % 10, sample.dc1_voltage / 10,
+                     sample.dc1_voltage % 10, sample.dc1_current / 10, sample.dc1_current % 10,
+                     sample.dc2_voltage / 10, sample.dc2_voltage % 10, sample.dc2_current / 10,
+                     sample.dc2_current % 10, sample.temperature, sample.mode, sample.error_bits);
+  this->chunk_len_ = std::min(size_t(len), sizeof(this->chunk_) - 1);
+  return true;
+}
+
+}  // namespace esphome::solax_x1_mini
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome::solax_x1_mini {
+
+// Decoded status report as stored in the history. 24 h of 10 s samples take 190 kB
+struct __attribute__((packed)) StatusSample {
+  uint32_t timestamp;  // millis() of the status report
+  uint32_t error_bits;
+  uint16_t ac_power;     // W
+  uint16_t ac_voltage;   // 0.1 V
+  uint16_t ac_current;   // 0.1 A
+  uint16_t dc1_voltage;  // 0.1 V
+  uint16_t dc2_voltage;  // 0.1 V
+  uint8_t dc1_current;   // 0.1 A, saturates at 25.5 A
+  uint8_t dc2_current;   // 0.1 A, saturates at 25.5 A
+  int8_t temperature;    // °C
+  uint8_t mode;
+};
+static_assert(sizeof(StatusSample) == 22, "Status samples must stay packed");
+
+// Samples per block. The history is allocated in blocks of about 4 kB, a fragmented heap rarely has 190 kB in one piece
+static const uint16_t HISTORY_BLOCK_SAMPLES = 186;
+
+// Ring buffer of the most recent status samples. Filled by the main loop, read() may run in any other task
+class StatusHistory {
+ public:
+  // Returns the number of samples which could be allocated
+  size_t allocate(size_t capacity);
+  void push(const StatusSample &sample);
+
+  size_t get_capacity() const { return this->capacity_; }
+  size_t get_size() const { return this->get_size(this->get_sequence()); }
+  // Number of samples stored after the given number of pushes
+  size_t get_size(uint32_t sequence) const { return sequence < this->capacity_ ? sequence : this->capacity_; }
+  // Number of samples pushed so far. The oldest stored sample is get_sequence() - get_size()
+  uint32_t get_sequence() const { return this->sequence_.load(std::memory_order_acquire); }
+  // Only valid for the stored samples. Main loop only, a concurrent push() may overwrite the sample
+  const StatusSample &get(uint32_t sequence) const;
+  // Copies a sample. Returns false if it isn't stored (anymore) or a push() overwrote it while it was copied
+  bool read(uint32_t sequence, StatusSample *sample) const;
+
+ protected:
+  std::vector<StatusSample *> blocks_;
+  size_t capacity_{0};
+  // Samples pushed so far and pushes started so far, one ahead while a sample is written
+  std::atomic<uint32_t> sequence_{0};
+  std::atomic<uint32_t> writing_{0};
+};
+
+enum HistoryFormat : uint8_t {
+  HISTORY_FORMAT_CSV,
+  HISTORY_FORMAT_BINARY,
+};
+
+// Binary export: "SXH", version and the little-endian millis() of the export, followed by the raw samples
+static const uint8_t HISTORY_BINARY_VERSION = 1;
+static const uint8_t HISTORY_BINARY_HEADER_SIZE = 8;
+
+// Streams the samples stored at construction time in chunks of any size, one sample at a time
+class HistoryExporter {
+ public:
+  HistoryExporter(const StatusHistory *history, HistoryFormat format, uint32_t now);
+
+  // Returns 0 once everything was exported
+  size_t read(uint8_t *buffer, size_t size);
+
+ protected:
+  bool next_chunk_();
+
+  const StatusHistory *history_;
+  HistoryFormat format_;
+  uint32_t now_;
+  uint32_t next_sequence_;
+  uint32_t end_sequence_;
+  bool header_sent_{false};
+  // Fits the CSV header and the longest CSV line
+  char chunk_[160];
+  size_t chunk_len_{0};
+  size_t chunk_pos_{0};
+};
+
+}  // namespace esphome::solax_x1_mini
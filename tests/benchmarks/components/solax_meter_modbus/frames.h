@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace esphome::solax_meter_modbus::benchmarks {
+
+// Real handshake request from the inverter (address 0x01, read holding register 0x0B)
+static const std::vector<uint8_t> HANDSHAKE_FRAME = {0x01, 0x03, 0x00, 0x0B, 0x00, 0x01, 0xF5, 0xC8};
+
+// Real read-power request from the inverter (address 0x01, read input registers 0x0C..0x0D)
+static const std::vector<uint8_t> READ_POWER_FRAME = {0x01, 0x04, 0x00, 0x0C, 0x00, 0x02, 0xB1, 0xC8};
+
+static const size_t RECORDED_FRAMES = 8;
+
+// A handshake followed by read-power polls, as sent by the inverter after power-up
+static std::vector<uint8_t> recorded_stream() {
+  std::vector<uint8_t> stream(HANDSHAKE_FRAME);
+  for (size_t i = 1; i < RECORDED_FRAMES; i++)
+    stream.insert(stream.end(), READ_POWER_FRAME.begin(), READ_POWER_FRAME.end());
+  return stream;
+}
+
+// Adversarial input: every request preceded by pseudo-random line noise
+static std::vector<uint8_t> noisy_stream() {
+  std::vector<uint8_t> stream;
+  uint32_t seed = 0x12345678;
+  for (size_t i = 0; i < RECORDED_FRAMES; i++) {
+    for (int j = 0; j < 4; j++) {
+      seed = seed * 1664525 + 1013904223;
+      stream.push_back(seed >> 24);
+    }
+    const auto &frame = (i == 0) ? HANDSHAKE_FRAME : READ_POWER_FRAME;
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+  return stream;
+}
+
+// Adversarial input: every request preceded by a copy cut off in the middle
+static std::vector<uint8_t> truncated_stream() {
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < RECORDED_FRAMES; i++) {
+    const auto &frame = (i == 0) ? HANDSHAKE_FRAME : READ_POWER_FRAME;
+    stream.insert(stream.end(), frame.begin(), frame.begin() + frame.size() / 2);
+    stream.insert(stream.end(), frame.begin(), frame.end());
+  }
+  return stream;
+}
+
+// Adversarial input: the recorded requests with a corrupted CRC
+static std::vector<uint8_t> bad_checksum_stream() {
+  std::vector<uint8_t> stream = recorded_stream();
+  for (size_t pos = HANDSHAKE_FRAME.size() - 1; pos < stream.size(); pos += READ_POWER_FRAME.size())
+    stream[pos] ^= 0xFF;
+  return stream;
+}
+
+}  // namespace esphome::solax_meter_modbus::benchmarks
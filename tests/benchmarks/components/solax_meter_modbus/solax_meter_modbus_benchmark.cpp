@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include "esphome/components/solax_meter_modbus/solax_meter_modbus.h"
+#include "frames.h"
+#include "../../../components/allocation_counter.h"
+
+namespace esphome::solax_meter_modbus::benchmarks {
+
+class NullSolaxMeterModbusDevice : public SolaxMeterModbusDevice {
+ public:
+  size_t frames{0};
+
+  void on_solax_meter_modbus_data(const uint8_t *data, size_t len) override {
+    benchmark::DoNotOptimize(data);
+    this->frames++;
+  }
+  void send(int16_t) override {}
+  void send(float) override {}
+  void send_raw(const std::vector<uint8_t> &) override {}
+};
+
+class BenchmarkSolaxMeterModbus : public SolaxMeterModbus {
+ public:
+  void loop() override {}
+
+  // Same as loop(): one read_array() per buffer fill, then a single scan
+  void feed_bulk(const std::vector<uint8_t> &stream) {
+    size_t pos = 0;
+    while (pos < stream.size()) {
+      size_t len = std::min(stream.size() - pos, sizeof(this->rx_buffer_) - this->rx_buffer_len_);
+      memcpy(this->rx_buffer_ + this->rx_buffer_len_, stream.data() + pos, len);
+      this->rx_buffer_len_ += len;
+      pos += len;
+      this->parse_rx_buffer_();
+    }
+  }
+};
+
+// Feeds the stream once per iteration and reports dispatched frames/s and heap allocations per fed frame
+static void run_bulk(benchmark::State &state, const std::vector<uint8_t> &stream) {
+  BenchmarkSolaxMeterModbus modbus;
+  NullSolaxMeterModbusDevice device;
+  device.set_address(0x01);
+  modbus.register_device(&device);
+
+  size_t allocations_before = allocation_count;
+  for (auto _ : state)
+    modbus.feed_bulk(stream);
+  size_t allocations = allocation_count - allocations_before;
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * stream.size());
+  state.counters["frames"] = benchmark::Counter(double(device.frames), benchmark::Counter::kIsRate);
+  state.counters["allocs/frame"] = double(allocations) / double(state.iterations() * RECORDED_FRAMES);
+}
+
+static void BM_SolaxMeterModbusBulk(benchmark::State &state) { run_bulk(state, recorded_stream()); }
+BENCHMARK(BM_SolaxMeterModbusBulk);
+
+static void BM_SolaxMeterModbusNoise(benchmark::State &state) { run_bulk(state, noisy_stream()); }
+BENCHMARK(BM_SolaxMeterModbusNoise);
+
+static void BM_SolaxMeterModbusTruncated(benchmark::State &state) { run_bulk(state, truncated_stream()); }
+BENCHMARK(BM_SolaxMeterModbusTruncated);
+
+static void BM_SolaxMeterModbusBadChecksum(benchmark::State &state) { run_bulk(state, bad_checksum_stream()); }
+BENCHMARK(BM_SolaxMeterModbusBadChecksum);
+
+}  // namespace esphome::solax_meter_modbus::benchmarks
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace esphome::solax_modbus::benchmarks {
+
+// Source: docs/pdus/solax-x1-mini-g1-status.txt (data_len 0x34: 52 bytes)
+static const std::vector<uint8_t> G1_STATUS_FRAME = {
+    0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0x34, 0x00, 0x1A, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x21, 0x13, 0x87, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00,
+    0x12, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xD6,
+};
+
+// Source: docs/pdus/solax-x1-mini-g2-status.txt (data_len 0x32: 50 bytes)
+static const std::vector<uint8_t> G2_STATUS_FRAME = {
+    0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0x32, 0x00, 0x21, 0x00, 0x02, 0x07, 0xEC, 0x00, 0x00,
+    0x00, 0x1D, 0x00, 0x00, 0x00, 0x18, 0x09, 0x55, 0x13, 0x80, 0x02, 0x2B, 0xFF, 0xFF, 0x00, 0x00, 0x5D,
+    0xAF, 0x00, 0x00, 0x10, 0x50, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xA4,
+};
+
+// Source: docs/pdus/solax-x1-mini-g3-status.txt (data_len 0x38: 56 bytes)
+static const std::vector<uint8_t> G3_STATUS_FRAME = {
+    0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0x38, 0x00, 0x1A, 0x00, 0x03, 0x04, 0x0C, 0x00, 0x00,
+    0x00, 0x19, 0x00, 0x00, 0x00, 0x0B, 0x08, 0xFC, 0x13, 0x8A, 0x00, 0xF8, 0xFF, 0xFF, 0x00, 0x00, 0x00,
+    0x2B, 0x00, 0x00, 0x00, 0x0D, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8A, 0x00, 0xDE, 0x08, 0x5F,
+};
+
+// Source: docs/pdus/solax-x1-mini-g1-config.txt (data_len 0x44: 68 bytes)
+static const std::vector<uint8_t> G1_CONFIG_FRAME = {
+    0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x84, 0x44, 0x01, 0xE0, 0x00, 0x3C, 0x04, 0x0B, 0x0B, 0x3B,
+    0x12, 0x8E, 0x14, 0x1E, 0x03, 0x84, 0x09, 0xE2, 0x07, 0x30, 0x0B, 0x3B, 0x12, 0x8E, 0x14, 0x1E, 0x00,
+    0x01, 0x00, 0x64, 0x64, 0x5F, 0x32, 0x64, 0x00, 0x00, 0x13, 0x9C, 0x00, 0x05, 0x00, 0x67, 0x00, 0x61,
+    0x00, 0x64, 0x03, 0xE8, 0x08, 0x98, 0x09, 0xC4, 0x0A, 0x5A, 0x00, 0x2C, 0x00, 0x2C, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x0D, 0x9D,
+};
+
+// All recorded frames back to back, as they would arrive on a busy bus
+static std::vector<uint8_t> recorded_stream() {
+  std::vector<uint8_t> stream;
+  for (const auto *frame : {&G1_STATUS_FRAME, &G2_STATUS_FRAME, &G3_STATUS_FRAME, &G1_CONFIG_FRAME})
+    stream.insert(stream.end(), frame->begin(), frame->end());
+  return stream;
+}
+
+// Adversarial input: the recorded frames separated by pseudo-random line noise
+static std::vector<uint8_t> noisy_stream() {
+  std::vector<uint8_t> stream;
+  uint32_t seed = 0x12345678;
+  for (const auto *frame : {&G1_STATUS_FRAME, &G2_STATUS_FRAME, &G3_STATUS_FRAME, &G1_CONFIG_FRAME}) {
+    for (int i = 0; i < 16; i++) {
+      seed = seed * 1664525 + 1013904223;
+      stream.push_back(seed >> 24);
+    }
+    stream.insert(stream.end(), frame->begin(), frame->end());
+  }
+  return stream;
+}
+
+// Adversarial input: every frame is preceded by a copy cut off in the middle
+static std::vector<uint8_t> truncated_stream() {
+  std::vector<uint8_t> stream;
+  for (const auto *frame : {&G1_STATUS_FRAME, &G2_STATUS_FRAME, &G3_STATUS_FRAME, &G1_CONFIG_FRAME}) {
+    stream.insert(stream.end(), frame->begin(), frame->begin() + frame->size() / 2);
+    stream.insert(stream.end(), frame->begin(), frame->end());
+  }
+  return stream;
+}
+
+// Adversarial input: the recorded frames with a corrupted checksum
+static std::vector<uint8_t> bad_checksum_stream() {
+  std::vector<uint8_t> stream = recorded_stream();
+  size_t pos = 0;
+  for (const auto *frame : {&G1_STATUS_FRAME, &G2_STATUS_FRAME, &G3_STATUS_FRAME, &G1_CONFIG_FRAME}) {
+    pos += frame->size();
+    stream[pos - 1] ^= 0xFF;
+  }
+  return stream;
+}
+
+}  // namespace esphome::solax_modbus::benchmarks
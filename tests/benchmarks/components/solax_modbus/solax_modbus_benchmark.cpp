@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include "esphome/components/solax_modbus/solax_modbus.h"
+#include "frames.h"
+#include "../../../components/allocation_counter.h"
+
+namespace esphome::solax_modbus::benchmarks {
+
+static const size_t RECORDED_FRAMES = 4;
+
+class NullSolaxModbusDevice : public SolaxModbusDevice {
+ public:
+  size_t frames{0};
+
+  void on_solax_modbus_data(const uint8_t &function, const uint8_t *data, size_t len) override {
+    benchmark::DoNotOptimize(data);
+    this->frames++;
+  }
+};
+
+class BenchmarkSolaxModbus : public SolaxModbus {
+ public:
+  void loop() override {}
+
+  // Former loop(): one read_byte() and parser call per byte
+  void feed_byte_at_a_time(const std::vector<uint8_t> &stream) {
+    for (uint8_t byte : stream) {
+      if (!this->parse_solax_modbus_byte_(byte))
+        this->rx_buffer_len_ = 0;
+    }
+  }
+
+  // Current loop(): one read_array() per buffer fill, then a single scan
+  void feed_bulk(const std::vector<uint8_t> &stream) {
+    size_t pos = 0;
+    while (pos < stream.size()) {
+      size_t len = std::min(stream.size() - pos, size_t(SOLAX_MAX_FRAME_SIZE - this->rx_buffer_len_));
+      memcpy(this->rx_buffer_ + this->rx_buffer_len_, stream.data() + pos, len);
+      this->rx_buffer_len_ += len;
+      pos += len;
+      this->parse_rx_buffer_();
+    }
+  }
+};
+
+// Feeds the stream once per iteration and reports dispatched frames/s and heap allocations per fed frame
+static void run_bulk(benchmark::State &state, const std::vector<uint8_t> &stream) {
+  BenchmarkSolaxModbus modbus;
+  NullSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  size_t allocations_before = allocation_count;
+  for (auto _ : state)
+    modbus.feed_bulk(stream);
+  size_t allocations = allocation_count - allocations_before;
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * stream.size());
+  state.counters["frames"] = benchmark::Counter(double(device.frames), benchmark::Counter::kIsRate);
+  state.counters["allocs/frame"] = double(allocations) / double(state.iterations() * RECORDED_FRAMES);
+}
+
+static void BM_SolaxModbusByteAtATime(benchmark::State &state) {
+  BenchmarkSolaxModbus modbus;
+  NullSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+  const auto stream = recorded_stream();
+
+  for (auto _ : state)
+    modbus.feed_byte_at_a_time(stream);
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * stream.size());
+  state.counters["frames"] = benchmark::Counter(double(device.frames), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SolaxModbusByteAtATime);
+
+static void BM_SolaxModbusBulk(benchmark::State &state) { run_bulk(state, recorded_stream()); }
+BENCHMARK(BM_SolaxModbusBulk);
+
+// The recorded frames are addressed to the last of many devices on the bus
+static void BM_SolaxModbusManyDevices(benchmark::State &state) {
+  BenchmarkSolaxModbus modbus;
+  std::vector<NullSolaxModbusDevice> devices(32);
+  for (size_t i = 0; i < devices.size(); i++) {
+    devices[i].set_address(0x0A + devices.size() - 1 - i);
+    modbus.register_device(&devices[i]);
+  }
+  const auto stream = recorded_stream();
+
+  for (auto _ : state)
+    modbus.feed_bulk(stream);
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * stream.size());
+  state.counters["frames"] = benchmark::Counter(double(devices.back().frames), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SolaxModbusManyDevices);
+
+static void BM_SolaxModbusNoise(benchmark::State &state) { run_bulk(state, noisy_stream()); }
+BENCHMARK(BM_SolaxModbusNoise);
+
+static void BM_SolaxModbusTruncated(benchmark::State &state) { run_bulk(state, truncated_stream()); }
+BENCHMARK(BM_SolaxModbusTruncated);
+
+static void BM_SolaxModbusBadChecksum(benchmark::State &state) { run_bulk(state, bad_checksum_stream()); }
+BENCHMARK(BM_SolaxModbusBadChecksum);
+
+}  // namespace esphome::solax_modbus::benchmarks
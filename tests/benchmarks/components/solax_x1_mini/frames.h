@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace esphome::solax_x1_mini::benchmarks {
+
+// Source: docs/pdus/solax-x1-mini-g1-status.txt (data_len 0x34: 52 bytes)
+static const std::vector<uint8_t> G1_STATUS_FRAME = {
+    0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0x34, 0x00, 0x1A, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x21, 0x13, 0x87, 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0x00,
+    0x12, 0x00, 0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0xD6,
+};
+
+// Source: docs/pdus/solax-x1-mini-g2-status.txt (data_len 0x32: 50 bytes)
+static const std::vector<uint8_t> G2_STATUS_FRAME = {
+    0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0x32, 0x00, 0x21, 0x00, 0x02, 0x07, 0xEC, 0x00, 0x00,
+    0x00, 0x1D, 0x00, 0x00, 0x00, 0x18, 0x09, 0x55, 0x13, 0x80, 0x02, 0x2B, 0xFF, 0xFF, 0x00, 0x00, 0x5D,
+    0xAF, 0x00, 0x00, 0x10, 0x50, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07, 0xA4,
+};
+
+// Source: docs/pdus/solax-x1-mini-g3-status.txt (data_len 0x38: 56 bytes)
+static const std::vector<uint8_t> G3_STATUS_FRAME = {
+    0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0x38, 0x00, 0x1A, 0x00, 0x03, 0x04, 0x0C, 0x00, 0x00,
+    0x00, 0x19, 0x00, 0x00, 0x00, 0x0B, 0x08, 0xFC, 0x13, 0x8A, 0x00, 0xF8, 0xFF, 0xFF, 0x00, 0x00, 0x00,
+    0x2B, 0x00, 0x00, 0x00, 0x0D, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8A, 0x00, 0xDE, 0x08, 0x5F,
+};
+
+static const size_t RECORDED_FRAMES = 3;
+
+// All recorded status reports back to back, as received by consecutive polls
+static std::vector<uint8_t> recorded_stream() {
+  std::vector<uint8_t> stream;
+  for (const auto *frame : {&G1_STATUS_FRAME, &G2_STATUS_FRAME, &G3_STATUS_FRAME})
+    stream.insert(stream.end(), frame->begin(), frame->end());
+  return stream;
+}
+
+}  // namespace esphome::solax_x1_mini::benchmarks
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include "esphome/components/solax_modbus/solax_modbus.h"
+#include "esphome/components/solax_x1_mini/solax_x1_mini.h"
+#include "frames.h"
+#include "../../../components/allocation_counter.h"
+
+namespace esphome::solax_x1_mini::benchmarks {
+
+static const uint8_t FUNCTION_STATUS_REPORT = 0x82;
+static const size_t PAYLOAD_OFFSET = 9;
+static const size_t CHECKSUM_SIZE = 2;
+
+class BenchmarkSolaxModbus : public solax_modbus::SolaxModbus {
+ public:
+  void loop() override {}
+
+  // Same as loop(): one read_array() per buffer fill, then a single scan
+  void feed_bulk(const std::vector<uint8_t> &stream) {
+    size_t pos = 0;
+    while (pos < stream.size()) {
+      size_t len = std::min(stream.size() - pos, size_t(solax_modbus::SOLAX_MAX_FRAME_SIZE - this->rx_buffer_len_));
+      memcpy(this->rx_buffer_ + this->rx_buffer_len_, stream.data() + pos, len);
+      this->rx_buffer_len_ += len;
+      pos += len;
+      this->parse_rx_buffer_();
+    }
+  }
+};
+
+// Inverter with every status sensor configured, so each frame pays the full publish cost
+class BenchmarkSolaxX1Mini : public SolaxX1Mini {
+ public:
+  BenchmarkSolaxX1Mini() {
+    this->set_address(0x0A);
+    for (size_t i = 0; i < STATUS_SENSOR_SLOTS; i++)
+      this->status_sensors_[i] = &this->sensors_[i];
+    this->set_mode_name_text_sensor(&this->mode_name_);
+    this->set_errors_text_sensor(&this->errors_);
+  }
+  void update() override {}
+
+ protected:
+  sensor::Sensor sensors_[STATUS_SENSOR_SLOTS];
+  text_sensor::TextSensor mode_name_;
+  text_sensor::TextSensor errors_;
+};
+
+// Decode and publish only: the payloads as handed over by SolaxModbus
+static void BM_SolaxX1MiniDecodeStatus(benchmark::State &state) {
+  BenchmarkSolaxX1Mini inverter;
+
+  size_t allocations_before = allocation_count;
+  for (auto _ : state) {
+    for (const auto *frame : {&G1_STATUS_FRAME, &G2_STATUS_FRAME, &G3_STATUS_FRAME}) {
+      inverter.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame->data() + PAYLOAD_OFFSET,
+                                    frame->size() - PAYLOAD_OFFSET - CHECKSUM_SIZE);
+    }
+  }
+  size_t allocations = allocation_count - allocations_before;
+
+  state.counters["frames"] =
+      benchmark::Counter(double(state.iterations() * RECORDED_FRAMES), benchmark::Counter::kIsRate);
+  state.counters["allocs/frame"] = double(allocations) / double(state.iterations() * RECORDED_FRAMES);
+}
+BENCHMARK(BM_SolaxX1MiniDecodeStatus);
+
+// Parse, dispatch, decode and publish: the raw bus stream fed through SolaxModbus
+static void BM_SolaxX1MiniParseDispatchDecode(benchmark::State &state) {
+  BenchmarkSolaxModbus modbus;
+  BenchmarkSolaxX1Mini inverter;
+  modbus.register_device(&inverter);
+  const auto stream = recorded_stream();
+
+  size_t allocations_before = allocation_count;
+  for (auto _ : state)
+    modbus.feed_bulk(stream);
+  size_t allocations = allocation_count - allocations_before;
+
+  state.SetBytesProcessed(int64_t(state.iterations()) * stream.size());
+  state.counters["frames"] =
+      benchmark::Counter(double(state.iterations() * RECORDED_FRAMES), benchmark::Counter::kIsRate);
+  state.counters["allocs/frame"] = double(allocations) / double(state.iterations() * RECORDED_FRAMES);
+}
+BENCHMARK(BM_SolaxX1MiniParseDispatchDecode);
+
+}  // namespace esphome::solax_x1_mini::benchmarks
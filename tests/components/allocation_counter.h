@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Counts the heap allocations of the whole test or benchmark binary. The replacements are weak, so the
+// header can be included from several test files linked into the same binary.
+inline std::atomic<size_t> allocation_count{0};
+
+__attribute__((weak)) void *operator new(size_t size) {
+  allocation_count++;
+  if (void *ptr = std::malloc(size))
+    return ptr;
+  throw std::bad_alloc();
+}
+__attribute__((weak)) void *operator new[](size_t size) {
+  allocation_count++;
+  if (void *ptr = std::malloc(size))
+    return ptr;
+  throw std::bad_alloc();
+}
+__attribute__((weak)) void operator delete(void *ptr) noexcept { std::free(ptr); }
+__attribute__((weak)) void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+__attribute__((weak)) void operator delete[](void *ptr) noexcept { std::free(ptr); }
+__attribute__((weak)) void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
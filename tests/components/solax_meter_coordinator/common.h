@@ -0,0 +1,17 @@
+#pragma once
+#include "esphome/components/solax_meter_coordinator/solax_meter_coordinator.h"
+
+namespace esphome::solax_meter_coordinator::testing {
+
+class TestableSolaxMeterGateway : public solax_meter_gateway::SolaxMeterGateway {
+ public:
+  void update() override {}
+  void send_frame(const uint8_t *frame, size_t len) override {}
+
+  float get_power_demand() const { return this->power_demand_; }
+};
+
+// Raw: 0x01 0x04 0x00 0x0C 0x00 0x02 0xB1 0xC8  (Read power 32-bit float)
+static const std::vector<uint8_t> READ_POWER_32BIT_FLOAT_REQUEST = {0x04, 0x00, 0x0C, 0x00, 0x02};
+
+}  // namespace esphome::solax_meter_coordinator::testing
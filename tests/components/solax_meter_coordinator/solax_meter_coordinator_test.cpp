@@ -0,0 +1,169 @@
+#include "esphome/components/solax_meter_coordinator/solax_meter_coordinator.h"
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/solax_meter_modbus/solax_meter_modbus.h"
+#include "common.h"
+#include <gtest/gtest.h>
+
+namespace esphome::solax_meter_coordinator::testing {
+
+static void add_gateways(SolaxMeterCoordinator &coordinator, TestableSolaxMeterGateway *gateways, float rated_power0,
+                         float rated_power1) {
+  coordinator.add_gateway(&gateways[0], rated_power0);
+  coordinator.add_gateway(&gateways[1], rated_power1);
+}
+
+// ── Weighted split ────────────────────────────────────────────────────────────
+
+TEST(SolaxMeterCoordinatorTest, WeightedByRatedPower) {
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  add_gateways(coordinator, gateways, 600.0f, 300.0f);
+
+  coordinator.set_power_demand(300.0f, 0);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 0), 200.0f);
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 0), 100.0f);
+
+  // Clamped to the rated power
+  coordinator.set_power_demand(1200.0f, 0);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 0), 600.0f);
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 0), 300.0f);
+}
+
+TEST(SolaxMeterCoordinatorTest, NoDemandBeforeFirstMeasurement) {
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  add_gateways(coordinator, gateways, 600.0f, 600.0f);
+
+  EXPECT_TRUE(std::isnan(coordinator.poll(0, 0)));
+}
+
+// ── Least recently polled ─────────────────────────────────────────────────────
+
+TEST(SolaxMeterCoordinatorTest, NextPollTakesTheDeficit) {
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  add_gateways(coordinator, gateways, 600.0f, 600.0f);
+  coordinator.set_strategy(STRATEGY_LEAST_RECENTLY_POLLED);
+
+  coordinator.set_power_demand(400.0f, 0);
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 0), 400.0f);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 10), 0.0f);
+
+  // The deficit beyond the rated power is left for the other gateway
+  coordinator.set_power_demand(1000.0f, 1000);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 1000), 600.0f);
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 1010), 400.0f);
+
+  coordinator.set_power_demand(700.0f, 2000);
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 2000), 100.0f);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 2010), 600.0f);
+}
+
+// ── Round robin ───────────────────────────────────────────────────────────────
+
+TEST(SolaxMeterCoordinatorTest, RoundRobinPassesTheTurn) {
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  add_gateways(coordinator, gateways, 600.0f, 600.0f);
+  coordinator.set_strategy(STRATEGY_ROUND_ROBIN);
+
+  coordinator.set_power_demand(400.0f, 0);
+  // Not its turn
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 0), 0.0f);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 0), 400.0f);
+
+  coordinator.set_power_demand(500.0f, 1000);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 1000), 400.0f);
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 1000), 100.0f);
+}
+
+// ── Hysteresis and release ────────────────────────────────────────────────────
+
+TEST(SolaxMeterCoordinatorTest, SmallChangesSuppressedByHysteresis) {
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  add_gateways(coordinator, gateways, 600.0f, 600.0f);
+  coordinator.set_hysteresis(20.0f);
+
+  coordinator.set_power_demand(400.0f, 0);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 0), 200.0f);
+  coordinator.set_power_demand(420.0f, 1000);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 1000), 200.0f);
+  coordinator.set_power_demand(480.0f, 2000);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 2000), 240.0f);
+}
+
+TEST(SolaxMeterCoordinatorTest, SilentGatewayReleasesItsShare) {
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  add_gateways(coordinator, gateways, 600.0f, 600.0f);
+  coordinator.set_strategy(STRATEGY_LEAST_RECENTLY_POLLED);
+  coordinator.set_release_timeout(10000);
+
+  coordinator.set_power_demand(400.0f, 0);
+  EXPECT_FLOAT_EQ(coordinator.poll(0, 0), 400.0f);
+
+  // The inverter of the first gateway stopped polling
+  coordinator.set_power_demand(400.0f, 20000);
+  EXPECT_FLOAT_EQ(coordinator.poll(1, 20000), 400.0f);
+}
+
+// ── Gateway integration ───────────────────────────────────────────────────────
+
+TEST(SolaxMeterCoordinatorTest, GatewaysReportTheirShare) {
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  sensor::Sensor power;
+  gateways[0].set_address(0x01);
+  gateways[1].set_address(0x02);
+  for (auto &gateway : gateways) {
+    gateway.set_power_sensor(&power);
+    gateway.setup();
+  }
+  add_gateways(coordinator, gateways, 600.0f, 300.0f);
+  coordinator.set_power_sensor(&power);
+  coordinator.setup();
+
+  power.publish_state(450.0f);
+  gateways[0].on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
+  gateways[1].on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
+
+  EXPECT_FLOAT_EQ(gateways[0].get_power_demand(), 300.0f);
+  EXPECT_FLOAT_EQ(gateways[1].get_power_demand(), 150.0f);
+}
+
+TEST(SolaxMeterCoordinatorTest, BusTaskPowerSamplesAreNoPolls) {
+  // The gateways of a bus task query their share on every power sample
+  solax_meter_modbus::SolaxMeterModbus bus;
+  bus.set_bus_task(true);
+  SolaxMeterCoordinator coordinator;
+  TestableSolaxMeterGateway gateways[2];
+  sensor::Sensor power;
+  gateways[0].set_address(0x03);
+  gateways[1].set_address(0x04);
+  for (auto &gateway : gateways) {
+    gateway.set_parent(&bus);
+    gateway.set_power_sensor(&power);
+    gateway.setup();
+  }
+  add_gateways(coordinator, gateways, 600.0f, 600.0f);
+  coordinator.set_strategy(STRATEGY_ROUND_ROBIN);
+  coordinator.set_power_sensor(&power);
+  coordinator.setup();
+
+  for (int i = 0; i < 3; i++)
+    power.publish_state(400.0f);
+
+  // Still the turn of the first gateway
+  EXPECT_FLOAT_EQ(coordinator.get_power_demand(0), 400.0f);
+  EXPECT_FLOAT_EQ(coordinator.get_power_demand(1), 0.0f);
+
+  // Only the poll passes the turn
+  gateways[0].on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
+  EXPECT_FLOAT_EQ(gateways[0].get_power_demand(), 400.0f);
+  power.publish_state(500.0f);
+  EXPECT_FLOAT_EQ(coordinator.get_power_demand(0), 400.0f);
+  EXPECT_FLOAT_EQ(coordinator.get_power_demand(1), 100.0f);
+}
+
+}  // namespace esphome::solax_meter_coordinator::testing
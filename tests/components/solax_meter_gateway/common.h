@@ -15,8 +15,17 @@ class TestableSolaxMeterGateway : public SolaxMeterGateway {
   void send(int16_t power) override {}
   void send(float power) override {}
   void send_raw(const std::vector<uint8_t> &payload) override {}
+  void send_frame(const uint8_t *frame, size_t len) override {
+    sent_frame.assign(frame, frame + len);
+    frames_sent++;
+  }
+
+  std::vector<uint8_t> sent_frame;
+  int frames_sent{0};
 
   void set_power_demand(float value) { this->power_demand_ = value; }
+  float get_power_demand() const { return this->power_demand_; }
+  EnergyCounter &get_energy_counter() { return this->energy_counter_; }
 };
 
 }  // namespace esphome::solax_meter_gateway::testing
@@ -7,7 +7,7 @@ namespace esphome::solax_meter_gateway::testing {
 // Source: solax_meter_modbus.cpp comments (real inverter traffic)
 // SolaxMeterModbus strips the address byte (data_offset=1) and passes
 // the remaining 5 bytes (data_len=5) to on_solax_meter_modbus_data().
-// data[2] is the register address that drives the switch() in the gateway.
+// data[1..2] is the first register and data[3..4] the register count.
 
 // Raw: 0x01 0x03 0x00 0x0B 0x00 0x01 0xF5 0xC8  (Handshake)
 static const std::vector<uint8_t> HANDSHAKE_REQUEST = {0x03, 0x00, 0x0B, 0x00, 0x01};
@@ -27,4 +27,10 @@ static const std::vector<uint8_t> READ_TOTAL_ENERGY_EXPORT_REQUEST = {0x04, 0x00
 // Raw: 0x01 0x03 0x00 0x08 0x00 0x04 0xC5 0xCB  (Read total energy)
 static const std::vector<uint8_t> READ_TOTAL_ENERGY_REQUEST = {0x03, 0x00, 0x08, 0x00, 0x04};
 
+// Raw: 0x01 0x04 0x00 0x00 0x00 0x4C 0xF1 0xFF  (SDM230 block read 0x0000-0x004B)
+static const std::vector<uint8_t> READ_SDM230_INPUT_REGISTERS_REQUEST = {0x04, 0x00, 0x00, 0x00, 0x4C};
+
+// Raw: 0x01 0x04 0x01 0x00 0x00 0x02 0x70 0x37  (Unmapped register)
+static const std::vector<uint8_t> READ_UNMAPPED_REGISTER_REQUEST = {0x04, 0x01, 0x00, 0x00, 0x02};
+
 }  // namespace esphome::solax_meter_gateway::testing
@@ -4,6 +4,7 @@
 #include "common.h"
 #include "frames.h"
 #include <gtest/gtest.h>
+#include <cmath>
 
 namespace esphome::solax_meter_gateway::testing {
 
@@ -17,7 +18,7 @@ TEST(SolaxMeterGatewayTest, AutoMode32BitFloat) {
   gw.set_operation_mode_text_sensor(&op_mode);
   gw.set_power_demand(500.0f);
 
-  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST);
+  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
 
   EXPECT_FLOAT_EQ(power_demand.state, 500.0f);
   EXPECT_EQ(op_mode.state, "Auto");
@@ -33,7 +34,7 @@ TEST(SolaxMeterGatewayTest, AutoMode16BitSint) {
   gw.set_operation_mode_text_sensor(&op_mode);
   gw.set_power_demand(300.0f);
 
-  gw.on_solax_meter_modbus_data(READ_POWER_16BIT_SINT_REQUEST);
+  gw.on_solax_meter_modbus_data(READ_POWER_16BIT_SINT_REQUEST.data(), READ_POWER_16BIT_SINT_REQUEST.size());
 
   EXPECT_FLOAT_EQ(power_demand.state, 300.0f);
   EXPECT_EQ(op_mode.state, "Auto");
@@ -52,7 +53,7 @@ TEST(SolaxMeterGatewayTest, EmergencyPowerOff) {
   emergency_off.publish_state(true);
   gw.set_power_demand(500.0f);
 
-  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST);
+  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
 
   EXPECT_FLOAT_EQ(power_demand.state, 0.0f);
   EXPECT_EQ(op_mode.state, "Off");
@@ -71,22 +72,428 @@ TEST(SolaxMeterGatewayTest, ManualModeNoNumber) {
   manual_mode.publish_state(true);
   gw.set_power_demand(500.0f);
 
-  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST);
+  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
 
   EXPECT_EQ(op_mode.state, "Manual");
   EXPECT_FLOAT_EQ(power_demand.state, 0.0f);
 }
 
+// ── Low latency reply: pre-encoded frame sent before publishing ──────────────
+
+TEST(SolaxMeterGatewayLowLatencyTest, Power32BitFloatFrame) {
+  TestableSolaxMeterGateway gw;
+  sensor::Sensor power_demand;
+  gw.set_address(0x01);
+  gw.set_low_latency_reply(true);
+  gw.set_power_demand_sensor(&power_demand);
+  gw.set_power_demand(500.0f);
+
+  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
+
+  std::vector<uint8_t> expected = {0x01, 0x04, 0x04, 0x43, 0xFA, 0x00, 0x00, 0xCE, 0x31};
+  EXPECT_EQ(gw.sent_frame, expected);
+  EXPECT_FLOAT_EQ(power_demand.state, 500.0f);
+}
+
+TEST(SolaxMeterGatewayLowLatencyTest, Power16BitSintFrame) {
+  TestableSolaxMeterGateway gw;
+  gw.set_address(0x01);
+  gw.set_low_latency_reply(true);
+  gw.set_power_demand(300.0f);
+
+  gw.on_solax_meter_modbus_data(READ_POWER_16BIT_SINT_REQUEST.data(), READ_POWER_16BIT_SINT_REQUEST.size());
+
+  std::vector<uint8_t> expected = {0x01, 0x03, 0x02, 0x01, 0x2C, 0xB8, 0x09};
+  EXPECT_EQ(gw.sent_frame, expected);
+}
+
+TEST(SolaxMeterGatewayLowLatencyTest, HandshakeFrame) {
+  TestableSolaxMeterGateway gw;
+  gw.set_address(0x01);
+  gw.set_low_latency_reply(true);
+
+  gw.on_solax_meter_modbus_data(HANDSHAKE_REQUEST.data(), HANDSHAKE_REQUEST.size());
+
+  std::vector<uint8_t> expected = {0x01, 0x03, 0x02, 0x00, 0x00, 0xB8, 0x44};
+  EXPECT_EQ(gw.sent_frame, expected);
+}
+
+TEST(SolaxMeterGatewayLowLatencyTest, EmergencyPowerOffSendsNothing) {
+  TestableSolaxMeterGateway gw;
+  text_sensor::TextSensor op_mode;
+  TestSwitch emergency_off;
+  gw.set_address(0x01);
+  gw.set_low_latency_reply(true);
+  gw.set_operation_mode_text_sensor(&op_mode);
+  gw.set_emergency_power_off_switch(&emergency_off);
+  emergency_off.publish_state(true);
+
+  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
+
+  EXPECT_EQ(gw.frames_sent, 0);
+  EXPECT_EQ(op_mode.state, "Off");
+}
+
+TEST(SolaxMeterGatewayLowLatencyTest, TurnaroundTimePublished) {
+  TestableSolaxMeterGateway gw;
+  sensor::Sensor turnaround_time;
+  gw.set_address(0x01);
+  gw.set_low_latency_reply(true);
+  gw.set_turnaround_time_sensor(&turnaround_time);
+
+  gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_REQUEST.data(), READ_TOTAL_ENERGY_REQUEST.size());
+
+  EXPECT_EQ(gw.sent_frame.size(), 13u);
+  EXPECT_TRUE(turnaround_time.has_state());
+}
+
+// ── Register map ──────────────────────────────────────────────────────────────
+
+TEST(SolaxMeterGatewayRegisterMapTest, WideReadAnsweredInOneFrame) {
+  TestableSolaxMeterGateway gw;
+  sensor::Sensor power_demand;
+  gw.set_address(0x01);
+  gw.set_power_demand_sensor(&power_demand);
+  gw.set_power_demand(500.0f);
+
+  gw.on_solax_meter_modbus_data(READ_SDM230_INPUT_REGISTERS_REQUEST.data(), READ_SDM230_INPUT_REGISTERS_REQUEST.size());
+
+  ASSERT_EQ(gw.sent_frame.size(), 5u + 2 * 0x4C);
+  EXPECT_EQ(gw.sent_frame[1], 0x04);
+  EXPECT_EQ(gw.sent_frame[2], 2 * 0x4C);
+  // Voltage (0x0000) and power (0x000C) as 32-bit floats
+  std::vector<uint8_t> voltage(gw.sent_frame.begin() + 3, gw.sent_frame.begin() + 7);
+  std::vector<uint8_t> power(gw.sent_frame.begin() + 3 + 2 * 0x0C, gw.sent_frame.begin() + 7 + 2 * 0x0C);
+  EXPECT_EQ(voltage, std::vector<uint8_t>({0x43, 0x66, 0x00, 0x00}));
+  EXPECT_EQ(power, std::vector<uint8_t>({0x43, 0xFA, 0x00, 0x00}));
+  EXPECT_FLOAT_EQ(power_demand.state, 500.0f);
+}
+
+TEST(SolaxMeterGatewayRegisterMapTest, UnmappedRegisterException) {
+  TestableSolaxMeterGateway gw;
+  gw.set_address(0x01);
+
+  gw.on_solax_meter_modbus_data(READ_UNMAPPED_REGISTER_REQUEST.data(), READ_UNMAPPED_REGISTER_REQUEST.size());
+
+  ASSERT_EQ(gw.sent_frame.size(), 5u);
+  EXPECT_EQ(gw.sent_frame[1], 0x84);
+  EXPECT_EQ(gw.sent_frame[2], 0x02);
+}
+
+// ── Power demand filter ───────────────────────────────────────────────────────
+
+TEST(PowerDemandFilterTest, NoSamplesReturnsNan) {
+  PowerDemandFilter filter;
+  filter.set_type(FILTER_MEDIAN);
+  EXPECT_TRUE(std::isnan(filter.evaluate(0)));
+}
+
+TEST(PowerDemandFilterTest, EmaFoldsInPendingSamples) {
+  PowerDemandFilter filter;
+  filter.set_type(FILTER_EMA);
+  filter.set_alpha(0.5f);
+
+  filter.add_sample(100.0f, 0);
+  EXPECT_FLOAT_EQ(filter.evaluate(0), 100.0f);
+
+  filter.add_sample(200.0f, 1000);
+  filter.add_sample(300.0f, 2000);
+  // 100 -> 150 -> 225
+  EXPECT_FLOAT_EQ(filter.evaluate(2000), 225.0f);
+  EXPECT_FLOAT_EQ(filter.evaluate(3000), 225.0f);
+}
+
+TEST(PowerDemandFilterTest, MedianRejectsSpike) {
+  PowerDemandFilter filter;
+  filter.set_type(FILTER_MEDIAN);
+  filter.set_window_size(3);
+
+  filter.add_sample(100.0f, 0);
+  filter.add_sample(5000.0f, 1000);
+  filter.add_sample(120.0f, 2000);
+
+  EXPECT_FLOAT_EQ(filter.evaluate(2000), 120.0f);
+}
+
+TEST(PowerDemandFilterTest, ExtrapolationFollowsRamp) {
+  PowerDemandFilter filter;
+  filter.set_type(FILTER_EXTRAPOLATE);
+  filter.set_window_size(4);
+  filter.set_max_extrapolation(3000);
+
+  // +100 W/s at irregular intervals
+  filter.add_sample(100.0f, 0);
+  filter.add_sample(250.0f, 1500);
+  filter.add_sample(350.0f, 2500);
+
+  EXPECT_NEAR(filter.evaluate(3500), 450.0f, 0.1f);
+  // The horizon is capped if the power sensor stalls
+  EXPECT_NEAR(filter.evaluate(60000), 650.0f, 0.1f);
+}
+
+TEST(SolaxMeterGatewayFilterTest, FilterEvaluatedOnPowerPollOnly) {
+  TestableSolaxMeterGateway gw;
+  sensor::Sensor power;
+  gw.set_address(0x01);
+  gw.set_power_sensor(&power);
+  gw.set_power_demand(0.0f);
+  gw.set_power_demand_filter(FILTER_MEDIAN, 0.5f, 3, 3000);
+  gw.setup();
+
+  power.publish_state(100.0f);
+  power.publish_state(5000.0f);
+  power.publish_state(120.0f);
+
+  gw.on_solax_meter_modbus_data(HANDSHAKE_REQUEST.data(), HANDSHAKE_REQUEST.size());
+  EXPECT_FLOAT_EQ(gw.get_power_demand(), 0.0f);
+
+  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
+  EXPECT_FLOAT_EQ(gw.get_power_demand(), 120.0f);
+}
+
+// ── Power demand controller ───────────────────────────────────────────────────
+
+// First order inverter model: the output follows the demand with a lag per poll
+static const float PLANT_RESPONSE = 0.3f;
+static const uint32_t POLL_INTERVAL_MS = 1000;
+
+template<typename Control> static int settling_polls(float load, Control control) {
+  float output = 0.0f;
+  int settled_since = -1;
+  for (int poll = 0; poll < 60; poll++) {
+    float demand = control(load - output, poll * POLL_INTERVAL_MS);
+    output += PLANT_RESPONSE * (demand - output);
+    if (std::fabs(output - load) <= 0.02f * load) {
+      if (settled_since < 0)
+        settled_since = poll + 1;
+    } else {
+      settled_since = -1;
+    }
+  }
+  return settled_since;
+}
+
+TEST(PowerDemandControllerTest, SettlesFasterThanPassthrough) {
+  const float load = 400.0f;
+  int passthrough = settling_polls(load, [load](float grid_power, uint32_t now) { return load; });
+
+  PowerDemandController controller;
+  controller.set_gains(1.5f, 1.0f);
+  controller.set_limits(0.0f, 600.0f);
+  int regulated = settling_polls(
+      load, [&controller](float grid_power, uint32_t now) { return controller.update(grid_power, now); });
+
+  ASSERT_GT(passthrough, 0);
+  ASSERT_GT(regulated, 0);
+  EXPECT_LT(regulated, passthrough);
+}
+
+TEST(PowerDemandControllerTest, ClampsToLimits) {
+  PowerDemandController controller;
+  controller.set_gains(1.5f, 1.0f);
+  controller.set_limits(0.0f, 600.0f);
+
+  EXPECT_FLOAT_EQ(controller.update(2000.0f, 0), 600.0f);
+  EXPECT_FLOAT_EQ(controller.update(-2000.0f, 1000), 0.0f);
+}
+
+TEST(PowerDemandControllerTest, NoWindupWhileSaturated) {
+  PowerDemandController controller;
+  controller.set_gains(1.0f, 1.0f);
+  controller.set_limits(0.0f, 600.0f);
+
+  // A large import saturates the output for a long time
+  for (uint32_t now = 0; now <= 60000; now += POLL_INTERVAL_MS) {
+    EXPECT_FLOAT_EQ(controller.update(1000.0f, now), 600.0f);
+  }
+  EXPECT_LE(controller.get_integral(), 600.0f);
+
+  // The demand drops immediately once the grid power reaches the setpoint
+  EXPECT_LT(controller.update(-100.0f, 61000), 600.0f);
+}
+
+TEST(PowerDemandControllerTest, SetpointShiftsTheEquilibrium) {
+  PowerDemandController controller;
+  controller.set_setpoint(50.0f);
+  controller.set_gains(1.0f, 1.0f);
+  controller.set_limits(0.0f, 600.0f);
+
+  // No correction if the grid power matches the setpoint
+  EXPECT_FLOAT_EQ(controller.update(50.0f, 0), 0.0f);
+  EXPECT_FLOAT_EQ(controller.update(150.0f, 1000), 200.0f);
+}
+
+TEST(SolaxMeterGatewayRegulationTest, RegulatedOnPowerPoll) {
+  TestableSolaxMeterGateway gw;
+  sensor::Sensor power;
+  text_sensor::TextSensor operation_mode;
+  gw.set_address(0x01);
+  gw.set_power_sensor(&power);
+  gw.set_operation_mode_text_sensor(&operation_mode);
+  gw.set_power_demand(0.0f);
+  gw.set_power_demand_controller(0.0f, 1.5f, 1.0f, 0.0f, 600.0f);
+  gw.setup();
+
+  power.publish_state(100.0f);
+  gw.on_solax_meter_modbus_data(HANDSHAKE_REQUEST.data(), HANDSHAKE_REQUEST.size());
+  EXPECT_FLOAT_EQ(gw.get_power_demand(), 0.0f);
+
+  // The first update has no integration step: the demand is the proportional part only
+  gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size());
+  EXPECT_FLOAT_EQ(gw.get_power_demand(), 150.0f);
+  EXPECT_EQ(operation_mode.state, "Auto regulated");
+
+  // The energy counter integrates the grid power, not the controller output
+  EXPECT_FLOAT_EQ(gw.get_energy_counter().get_last_power(), 100.0f);
+}
+
+// ── Energy counters ───────────────────────────────────────────────────────────
+
+TEST(EnergyCounterTest, TrapezoidalIntegration) {
+  EnergyCounter counter;
+  counter.set_max_gap(UINT32_MAX);
+  counter.add_sample(0.0f, 0);
+  counter.add_sample(600.0f, 3600000);
+  counter.add_sample(600.0f, 7200000);
+
+  // 300 Wh of the ramp plus 600 Wh at constant power
+  EXPECT_NEAR(counter.get_import_kwh(), 0.9f, 1e-6f);
+  EXPECT_FLOAT_EQ(counter.get_export_kwh(), 0.0f);
+}
+
+TEST(EnergyCounterTest, ZeroCrossingSplitsImportAndExport) {
+  EnergyCounter counter;
+  counter.set_max_gap(UINT32_MAX);
+  counter.add_sample(200.0f, 0);
+  counter.add_sample(-200.0f, 3600000);
+
+  EXPECT_NEAR(counter.get_import_kwh(), 0.05f, 1e-6f);
+  EXPECT_NEAR(counter.get_export_kwh(), 0.05f, 1e-6f);
+}
+
+TEST(EnergyCounterTest, GapsAreNotBridged) {
+  EnergyCounter counter;
+  counter.add_sample(500.0f, 0);
+  counter.add_sample(500.0f, 120000);
+  counter.interrupt();
+  counter.add_sample(500.0f, 121000);
+
+  EXPECT_FLOAT_EQ(counter.get_import_kwh(), 0.0f);
+  EXPECT_FALSE(counter.has_unsaved_changes());
+}
+
+TEST(EnergyCounterTest, SavesAreBatched) {
+  EnergyCounter counter;
+  counter.set_save_interval(300000);
+  counter.mark_saved(0);
+
+  for (uint32_t now = 0; now < 300000; now += 1000) {
+    counter.add_sample(400.0f, now);
+    EXPECT_FALSE(counter.is_save_due(now));
+  }
+  counter.add_sample(400.0f, 300000);
+  EXPECT_TRUE(counter.is_save_due(300000));
+  counter.mark_saved(300000);
+  EXPECT_FALSE(counter.is_save_due(600000));
+}
+
+TEST(SolaxMeterGatewayEnergyTest, CountersServedFromRegisters) {
+  TestableSolaxMeterGateway gw;
+  gw.set_address(0x01);
+  gw.get_energy_counter().restore({1000.0, 2000.0});
+
+  gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_IMPORT_REQUEST.data(), READ_TOTAL_ENERGY_IMPORT_REQUEST.size());
+  EXPECT_EQ(gw.sent_frame, std::vector<uint8_t>({0x01, 0x04, 0x04, 0x3F, 0x80, 0x00, 0x00, 0xF6, 0x78}));
+
+  gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_EXPORT_REQUEST.data(), READ_TOTAL_ENERGY_EXPORT_REQUEST.size());
+  EXPECT_EQ(gw.sent_frame[3], 0x40);
+  EXPECT_EQ(gw.sent_frame[4], 0x00);
+}
+
+// ── Bus task: replies from the snapshot published by the main loop ────────────
+
+TEST(SolaxMeterGatewayBusTaskTest, PowerSampleServedRightAway) {
+  solax_meter_modbus::SolaxMeterModbus bus;
+  bus.set_bus_task(true);
+  TestableSolaxMeterGateway gw;
+  sensor::Sensor power;
+  gw.set_parent(&bus);
+  gw.set_address(0x02);
+  gw.set_power_sensor(&power);
+  gw.setup();
+
+  uint8_t reply[solax_meter_modbus::METER_MAX_READ_RESPONSE_SIZE];
+  EXPECT_EQ(gw.encode_reply(READ_POWER_32BIT_FLOAT_REQUEST.data(), reply), 0u);
+
+  power.publish_state(500.0f);
+  ASSERT_EQ(gw.encode_reply(READ_POWER_32BIT_FLOAT_REQUEST.data(), reply), 9u);
+  EXPECT_EQ(std::vector<uint8_t>(reply + 3, reply + 7), std::vector<uint8_t>({0x43, 0xFA, 0x00, 0x00}));
+
+  // Not the value of the previous poll
+  power.publish_state(-300.0f);
+  ASSERT_EQ(gw.encode_reply(READ_POWER_16BIT_SINT_REQUEST.data(), reply), 7u);
+  EXPECT_EQ(std::vector<uint8_t>(reply + 3, reply + 5), std::vector<uint8_t>({0xFE, 0xD4}));
+}
+
+TEST(SolaxMeterGatewayBusTaskTest, EmergencyPowerOffStopsReplies) {
+  solax_meter_modbus::SolaxMeterModbus bus;
+  bus.set_bus_task(true);
+  TestableSolaxMeterGateway gw;
+  sensor::Sensor power;
+  TestSwitch emergency_off;
+  gw.set_parent(&bus);
+  gw.set_address(0x03);
+  gw.set_power_sensor(&power);
+  gw.set_emergency_power_off_switch(&emergency_off);
+  gw.setup();
+  power.publish_state(500.0f);
+
+  // The switch state reaches the bus task with the next request handled by the main loop
+  emergency_off.publish_state(true);
+  gw.on_solax_meter_modbus_data(HANDSHAKE_REQUEST.data(), HANDSHAKE_REQUEST.size());
+
+  uint8_t reply[solax_meter_modbus::METER_MAX_READ_RESPONSE_SIZE];
+  EXPECT_EQ(gw.encode_reply(READ_POWER_32BIT_FLOAT_REQUEST.data(), reply), 0u);
+}
+
+TEST(SolaxMeterGatewayEnergyTest, GatewaysAtTheSameAddressKeepTheirCounters) {
+  // Two UARTs, one inverter at address 0x01 on each
+  sensor::Sensor power;
+  TestableSolaxMeterGateway gateway_a;
+  gateway_a.set_address(0x01);
+  gateway_a.set_power_sensor(&power);
+  gateway_a.set_energy_key("energy_gateway_a");
+  gateway_a.setup();
+  gateway_a.get_energy_counter().set_max_gap(UINT32_MAX);
+  gateway_a.get_energy_counter().add_sample(600.0f, 0);
+  gateway_a.get_energy_counter().add_sample(600.0f, 3600000);
+  gateway_a.on_shutdown();
+
+  TestableSolaxMeterGateway gateway_b;
+  gateway_b.set_address(0x01);
+  gateway_b.set_power_sensor(&power);
+  gateway_b.set_energy_key("energy_gateway_b");
+  gateway_b.setup();
+  EXPECT_FLOAT_EQ(gateway_b.get_energy_counter().get_import_kwh(), 0.0f);
+
+  TestableSolaxMeterGateway restored_a;
+  restored_a.set_address(0x01);
+  restored_a.set_power_sensor(&power);
+  restored_a.set_energy_key("energy_gateway_a");
+  restored_a.setup();
+  EXPECT_FLOAT_EQ(restored_a.get_energy_counter().get_import_kwh(), 0.6f);
+}
+
 // ── Null sensors do not crash ─────────────────────────────────────────────────
 
 TEST(SolaxMeterGatewaySafetyTest, NullSensorsDoNotCrash) {
   TestableSolaxMeterGateway gw;
-  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST));
-  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_POWER_16BIT_SINT_REQUEST));
-  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(HANDSHAKE_REQUEST));
-  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_IMPORT_REQUEST));
-  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_EXPORT_REQUEST));
-  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_REQUEST));
+  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_POWER_32BIT_FLOAT_REQUEST.data(), READ_POWER_32BIT_FLOAT_REQUEST.size()));
+  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_POWER_16BIT_SINT_REQUEST.data(), READ_POWER_16BIT_SINT_REQUEST.size()));
+  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(HANDSHAKE_REQUEST.data(), HANDSHAKE_REQUEST.size()));
+  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_IMPORT_REQUEST.data(), READ_TOTAL_ENERGY_IMPORT_REQUEST.size()));
+  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_EXPORT_REQUEST.data(), READ_TOTAL_ENERGY_EXPORT_REQUEST.size()));
+  EXPECT_NO_FATAL_FAILURE(gw.on_solax_meter_modbus_data(READ_TOTAL_ENERGY_REQUEST.data(), READ_TOTAL_ENERGY_REQUEST.size()));
 }
 
 }  // namespace esphome::solax_meter_gateway::testing
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include "esphome/components/solax_meter_modbus/solax_meter_modbus.h"
 
@@ -38,11 +39,20 @@ class MockSolaxMeterModbusDevice : public SolaxMeterModbusDevice {
  public:
   std::vector<uint8_t> received_data;
   int call_count{0};
+  int encode_count{0};
+  size_t reply_len{0};
+  bool last_reply_sent{false};
 
-  void on_solax_meter_modbus_data(const std::vector<uint8_t> &data) override {
-    received_data = data;
+  void on_solax_meter_modbus_data(const uint8_t *data, size_t len) override {
+    received_data.assign(data, data + len);
+    last_reply_sent = this->reply_sent_;
     call_count++;
   }
+  size_t encode_reply(const uint8_t *request, uint8_t *buffer) override {
+    encode_count++;
+    memset(buffer, 0, this->reply_len);
+    return this->reply_len;
+  }
   void send(int16_t) override {}
   void send(float) override {}
   void send_raw(const std::vector<uint8_t> &) override {}
@@ -51,17 +61,36 @@ class MockSolaxMeterModbusDevice : public SolaxMeterModbusDevice {
 class TestableSolaxMeterModbus : public SolaxMeterModbus {
  public:
   void loop() override {}
+  using SolaxMeterModbus::check_transmit_;
   using SolaxMeterModbus::parse_solax_meter_modbus_byte_;
+  using SolaxMeterModbus::process_requests_;
+  using SolaxMeterModbus::read_rx_;
+  using SolaxMeterModbus::rx_pending_;
+
+  // What set_rx_wakeup_pin() enables, without a pin
+  void enable_rx_wakeup() { this->rx_wakeup_ = true; }
+  // An edge on the RX pin
+  void signal_rx() { SolaxMeterModbus::gpio_intr(this); }
+
+  bool is_transmitting() const { return this->transmitting_; }
+  uint32_t get_transmit_end_us() const { return this->transmit_end_us_; }
 
   bool feed(const std::vector<uint8_t> &frame) {
     bool result = false;
     for (uint8_t byte : frame) {
       result = parse_solax_meter_modbus_byte_(byte);
       if (!result)
-        this->rx_buffer_.clear();
+        this->rx_buffer_len_ = 0;
     }
     return result;
   }
+
+  // Simulates a single read_array() of everything available
+  bool feed_bulk(const std::vector<uint8_t> &bytes) {
+    memcpy(this->rx_buffer_ + this->rx_buffer_len_, bytes.data(), bytes.size());
+    this->rx_buffer_len_ += bytes.size();
+    return this->parse_rx_buffer_();
+  }
 };
 
 }  // namespace esphome::solax_meter_modbus::testing
@@ -95,4 +95,297 @@ TEST(SolaxMeterModbusTest, AddressMatchSelectsCorrectDevice) {
   EXPECT_EQ(device_02.call_count, 1);
 }
 
+TEST(SolaxMeterModbusTest, DuplicateAddressFirstDeviceOnly) {
+  TestableSolaxMeterModbus modbus;
+  MockSolaxMeterModbusDevice device_1, device_2;
+  device_1.set_address(0x01);
+  device_2.set_address(0x01);
+  modbus.register_device(&device_1);
+  modbus.register_device(&device_2);
+
+  modbus.feed(HANDSHAKE_FRAME);
+
+  EXPECT_EQ(device_1.call_count, 1);
+  EXPECT_EQ(device_2.call_count, 0);
+}
+
+TEST(SolaxMeterModbusTest, UnknownAddressesCounted) {
+  TestableSolaxMeterModbus modbus;
+  MockSolaxMeterModbusDevice device;
+  device.set_address(0x99);
+  modbus.register_device(&device);
+
+  for (int i = 0; i < 5; i++)
+    modbus.feed(HANDSHAKE_FRAME);
+
+  EXPECT_EQ(modbus.get_unknown_addresses(), 5u);
+  EXPECT_EQ(device.call_count, 0);
+}
+
+TEST(SolaxMeterModbusTest, BackToBackFramesInOneRead) {
+  TestableSolaxMeterModbus modbus;
+  MockSolaxMeterModbusDevice device;
+  device.set_address(0x01);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> bytes = HANDSHAKE_FRAME;
+  bytes.insert(bytes.end(), READ_POWER_FRAME.begin(), READ_POWER_FRAME.end());
+  bytes.insert(bytes.end(), HANDSHAKE_FRAME.begin(), HANDSHAKE_FRAME.begin() + 3);
+  EXPECT_TRUE(modbus.feed_bulk(bytes));
+
+  EXPECT_EQ(device.call_count, 2);
+  EXPECT_EQ(device.received_data[2], 0x0C);
+}
+
+TEST(SolaxMeterModbusTest, ResyncAfterLeadingNoise) {
+  TestableSolaxMeterModbus modbus;
+  MockSolaxMeterModbusDevice device;
+  device.set_address(0x01);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> bytes = {0xFF, 0x00, 0x7E};
+  bytes.insert(bytes.end(), READ_POWER_FRAME.begin(), READ_POWER_FRAME.end());
+  EXPECT_FALSE(modbus.feed_bulk(bytes));
+
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(modbus.get_resync_count(), 1u);
+  EXPECT_EQ(modbus.get_discarded_bytes(), 3u);
+}
+
+TEST(SolaxMeterModbusTest, ResyncAfterBadChecksum) {
+  TestableSolaxMeterModbus modbus;
+  MockSolaxMeterModbusDevice device;
+  device.set_address(0x01);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> bytes = HANDSHAKE_FRAME;
+  bytes.back() ^= 0xFF;  // corrupt CRC
+  bytes.insert(bytes.end(), READ_POWER_FRAME.begin(), READ_POWER_FRAME.end());
+  EXPECT_FALSE(modbus.feed_bulk(bytes));
+
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(device.received_data[2], 0x0C);
+  EXPECT_EQ(modbus.get_discarded_bytes(), HANDSHAKE_FRAME.size());
+}
+
+// ── Non-blocking transmit ─────────────────────────────────────────────────────
+
+TEST(SolaxMeterModbusTransmitTest, TransmitTimeFromUartSettings) {
+  TestableSolaxMeterModbus modbus;
+  // 9600 baud 8N1: 10 bits per byte
+  EXPECT_EQ(modbus.get_transmit_time_us(9), 9375u);
+  EXPECT_EQ(modbus.get_transmit_time_us(13), 13541u);
+}
+
+TEST(SolaxMeterModbusTransmitTest, BlockingTransmitFinishesInSend) {
+  TestableSolaxMeterModbus modbus;
+  const uint8_t frame[] = {0x01, 0x03, 0x02, 0x00, 0x00, 0xB8, 0x44};
+
+  modbus.send_frame(frame, sizeof(frame));
+
+  EXPECT_FALSE(modbus.is_transmitting());
+  EXPECT_EQ(modbus.tx.size(), sizeof(frame));
+}
+
+TEST(SolaxMeterModbusTransmitTest, NonBlockingTransmitFinishesInLoop) {
+  TestableSolaxMeterModbus modbus;
+  modbus.set_non_blocking_transmit(true);
+  const uint8_t frame[] = {0x01, 0x03, 0x02, 0x00, 0x00, 0xB8, 0x44};
+
+  modbus.send_frame(frame, sizeof(frame));
+  ASSERT_TRUE(modbus.is_transmitting());
+  uint32_t end = modbus.get_transmit_end_us();
+
+  // A second frame queued behind the first one extends the transmission
+  modbus.send_frame(frame, sizeof(frame));
+  EXPECT_EQ(modbus.get_transmit_end_us(), end + modbus.get_transmit_time_us(sizeof(frame) + 1));
+  end = modbus.get_transmit_end_us();
+
+  modbus.check_transmit_(end - 1);
+  EXPECT_TRUE(modbus.is_transmitting());
+  modbus.check_transmit_(end);
+  EXPECT_FALSE(modbus.is_transmitting());
+}
+
+// ── Bus task ──────────────────────────────────────────────────────────────────
+
+TEST(SolaxMeterModbusBusTaskTest, ReplySentBeforeDispatch) {
+  TestableSolaxMeterModbus modbus;
+  modbus.set_bus_task(true);
+  MockSolaxMeterModbusDevice device;
+  device.set_address(0x01);
+  device.reply_len = 7;
+  modbus.register_device(&device);
+
+  modbus.feed(HANDSHAKE_FRAME);
+
+  // The reply leaves from the bus task, the device callback waits for the main loop
+  EXPECT_EQ(device.encode_count, 1);
+  EXPECT_EQ(modbus.tx.size(), 7u);
+  EXPECT_EQ(device.call_count, 0);
+
+  modbus.process_requests_();
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_TRUE(device.last_reply_sent);
+  ASSERT_EQ(device.received_data.size(), 5u);
+  EXPECT_EQ(device.received_data[2], 0x0B);
+}
+
+TEST(SolaxMeterModbusBusTaskTest, NoReplyLeftToMainLoop) {
+  TestableSolaxMeterModbus modbus;
+  modbus.set_bus_task(true);
+  MockSolaxMeterModbusDevice device;
+  device.set_address(0x01);
+  modbus.register_device(&device);
+
+  modbus.feed(HANDSHAKE_FRAME);
+  modbus.process_requests_();
+
+  EXPECT_TRUE(modbus.tx.empty());
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_FALSE(device.last_reply_sent);
+}
+
+TEST(SolaxMeterModbusBusTaskTest, RequestQueueDropsWhenFull) {
+  MeterRequestQueue queue;
+  MeterRequest request{};
+
+  for (uint8_t i = 0; i < METER_REQUEST_QUEUE_SIZE - 1; i++) {
+    request.frame[0] = i;
+    EXPECT_TRUE(queue.push(request));
+  }
+  EXPECT_FALSE(queue.push(request));
+  EXPECT_EQ(queue.get_dropped(), 1u);
+
+  // Served in order and reusable after wrapping around
+  for (uint8_t i = 0; i < METER_REQUEST_QUEUE_SIZE - 1; i++) {
+    ASSERT_TRUE(queue.pop(&request));
+    EXPECT_EQ(request.frame[0], i);
+  }
+  EXPECT_FALSE(queue.pop(&request));
+  EXPECT_TRUE(queue.push(request));
+  EXPECT_TRUE(queue.pop(&request));
+}
+
+// ── RX wakeup ─────────────────────────────────────────────────────────────────
+
+TEST(SolaxMeterModbusRxWakeupTest, IdleLineSkipsParser) {
+  TestableSolaxMeterModbus modbus;
+  modbus.enable_rx_wakeup();
+  MockSolaxMeterModbusDevice device;
+  device.set_address(0x01);
+  modbus.register_device(&device);
+  modbus.rx.assign(HANDSHAKE_FRAME.begin(), HANDSHAKE_FRAME.end());
+
+  // Without an edge on the RX pin the UART isn't touched
+  modbus.read_rx_();
+  EXPECT_EQ(modbus.rx.size(), HANDSHAKE_FRAME.size());
+  EXPECT_EQ(device.call_count, 0);
+
+  modbus.signal_rx();
+  modbus.read_rx_();
+  EXPECT_TRUE(modbus.rx.empty());
+  EXPECT_EQ(device.call_count, 1);
+}
+
+TEST(SolaxMeterModbusRxWakeupTest, ReadsUntilLineIdle) {
+  TestableSolaxMeterModbus modbus;
+  modbus.enable_rx_wakeup();
+
+  EXPECT_FALSE(modbus.rx_pending_(0));
+  modbus.signal_rx();
+  EXPECT_TRUE(modbus.rx_pending_(1000));
+  EXPECT_TRUE(modbus.rx_pending_(1000 + RX_WAKEUP_HOLD_TIME));
+  EXPECT_FALSE(modbus.rx_pending_(1000 + RX_WAKEUP_HOLD_TIME + 1));
+}
+
+// ── Register map ──────────────────────────────────────────────────────────────
+
+static constexpr MeterRegister TEST_REGISTERS[] = {
+    {0x0008, 4, METER_REGISTER_RESERVED, 0},
+    {0x000C, 2, METER_REGISTER_FLOAT32, 1},
+    {0x000E, 1, METER_REGISTER_INT16, 1},
+    {0x0048, 2, METER_REGISTER_FLOAT32, 2},
+};
+static_assert(meter_registers_valid(TEST_REGISTERS), "Test registers must be sorted");
+
+static std::vector<uint8_t> encode_reply(SolaxMeterRegisterMap &map, const std::vector<uint8_t> &request) {
+  uint8_t buffer[METER_MAX_READ_RESPONSE_SIZE];
+  size_t len = map.encode_reply(buffer, 0x01, request.data());
+  return std::vector<uint8_t>(buffer, buffer + len);
+}
+
+TEST(SolaxMeterRegisterMapTest, SingleBlockReads) {
+  SolaxMeterRegisterMap map;
+  map.set_registers(TEST_REGISTERS);
+  map.set_value(1, 500.0f);
+
+  EXPECT_EQ(encode_reply(map, {0x03, 0x00, 0x0B, 0x00, 0x01}), make_meter_frame(0x01, {0x03, 0x02, 0x00, 0x00}));
+  EXPECT_EQ(encode_reply(map, {0x04, 0x00, 0x0C, 0x00, 0x02}),
+            make_meter_frame(0x01, {0x04, 0x04, 0x43, 0xFA, 0x00, 0x00}));
+  EXPECT_EQ(encode_reply(map, {0x03, 0x00, 0x0E, 0x00, 0x01}), make_meter_frame(0x01, {0x03, 0x02, 0x01, 0xF4}));
+  EXPECT_EQ(encode_reply(map, {0x03, 0x00, 0x08, 0x00, 0x04}).size(), 13u);
+}
+
+TEST(SolaxMeterRegisterMapTest, ReadAcrossContiguousBlocks) {
+  SolaxMeterRegisterMap map;
+  map.set_registers(TEST_REGISTERS);
+  map.set_value(1, -300.0f);
+
+  // Handshake register, 32-bit float and 16-bit power in one request
+  EXPECT_EQ(encode_reply(map, {0x04, 0x00, 0x0B, 0x00, 0x04}),
+            make_meter_frame(0x01, {0x04, 0x08, 0x00, 0x00, 0xC3, 0x96, 0x00, 0x00, 0xFE, 0xD4}));
+}
+
+TEST(SolaxMeterResponseCacheTest, ConstantFramesEncodedOnce) {
+  SolaxMeterRegisterMap map;
+  map.set_registers(TEST_REGISTERS);
+  SolaxMeterResponseCache cache;
+  const uint8_t handshake[5] = {0x03, 0x00, 0x0B, 0x00, 0x01};
+  uint8_t buffer[METER_MAX_READ_RESPONSE_SIZE];
+
+  cache.encode_reply(map, buffer, 0x01, handshake);
+  // A value the handshake doesn't contain changes
+  map.set_value(1, 500.0f);
+  size_t len = cache.encode_reply(map, buffer, 0x01, handshake);
+
+  EXPECT_EQ(cache.get_encodings(), 1u);
+  EXPECT_EQ(std::vector<uint8_t>(buffer, buffer + len), make_meter_frame(0x01, {0x03, 0x02, 0x00, 0x00}));
+}
+
+TEST(SolaxMeterResponseCacheTest, PowerFrameEncodedOnlyOnChange) {
+  SolaxMeterRegisterMap map;
+  map.set_registers(TEST_REGISTERS);
+  SolaxMeterResponseCache cache;
+  const uint8_t read_power[5] = {0x04, 0x00, 0x0C, 0x00, 0x02};
+  uint8_t buffer[METER_MAX_READ_RESPONSE_SIZE];
+
+  map.set_value(1, 500.0f);
+  cache.encode_reply(map, buffer, 0x01, read_power);
+  map.set_value(1, 500.0f);
+  size_t len = cache.encode_reply(map, buffer, 0x01, read_power);
+  EXPECT_EQ(cache.get_encodings(), 1u);
+  EXPECT_EQ(std::vector<uint8_t>(buffer, buffer + len), make_meter_frame(0x01, {0x04, 0x04, 0x43, 0xFA, 0x00, 0x00}));
+
+  map.set_value(1, 250.0f);
+  len = cache.encode_reply(map, buffer, 0x01, read_power);
+  EXPECT_EQ(cache.get_encodings(), 2u);
+  EXPECT_EQ(std::vector<uint8_t>(buffer, buffer + len), make_meter_frame(0x01, {0x04, 0x04, 0x43, 0x7A, 0x00, 0x00}));
+}
+
+TEST(SolaxMeterRegisterMapTest, ExceptionResponses) {
+  SolaxMeterRegisterMap map;
+  map.set_registers(TEST_REGISTERS);
+
+  // Write single register is not supported
+  EXPECT_EQ(encode_reply(map, {0x06, 0x00, 0x0C, 0x00, 0x01}), make_meter_frame(0x01, {0x86, 0x01}));
+  // Gap between 0x000F and 0x0047
+  EXPECT_EQ(encode_reply(map, {0x04, 0x00, 0x0E, 0x00, 0x04}), make_meter_frame(0x01, {0x84, 0x02}));
+  EXPECT_EQ(encode_reply(map, {0x04, 0x00, 0x00, 0x00, 0x02}), make_meter_frame(0x01, {0x84, 0x02}));
+  EXPECT_EQ(encode_reply(map, {0x04, 0x00, 0x4A, 0x00, 0x02}), make_meter_frame(0x01, {0x84, 0x02}));
+  // Register count out of range
+  EXPECT_EQ(encode_reply(map, {0x03, 0x00, 0x08, 0x00, 0x00}), make_meter_frame(0x01, {0x83, 0x03}));
+  EXPECT_EQ(encode_reply(map, {0x03, 0x00, 0x08, 0x00, 0x7E}), make_meter_frame(0x01, {0x83, 0x03}));
+}
+
 }  // namespace esphome::solax_meter_modbus::testing
@@ -1,14 +1,15 @@
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <vector>
 #include "esphome/components/solax_modbus/solax_modbus.h"
 
 namespace esphome::solax_modbus::testing {
 
 // Reimplements solax_modbus.cpp static chksum (sums bytes 0..len inclusive)
-static uint16_t solax_chksum(const uint8_t *data, uint8_t len) {
+static uint16_t solax_chksum(const uint8_t *data, size_t len) {
   uint16_t s = 0;
-  for (uint8_t i = 0; i <= len; i++)
+  for (size_t i = 0; i <= len; i++)
     s += data[i];
   return s;
 }
@@ -19,7 +20,18 @@ static std::vector<uint8_t> make_solax_frame(uint8_t address, uint8_t cc, uint8_
   std::vector<uint8_t> frame = {0xAA, 0x55, 0x00, address, 0x01, 0x00, cc, fc, static_cast<uint8_t>(data.size())};
   frame.insert(frame.end(), data.begin(), data.end());
   // chksum over frame[0..8+data_len-1]: length arg = 9 + data.size() - 1
-  uint16_t crc = solax_chksum(frame.data(), static_cast<uint8_t>(9 + data.size() - 1));
+  uint16_t crc = solax_chksum(frame.data(), 9 + data.size() - 1);
+  frame.push_back(crc >> 8);
+  frame.push_back(crc & 0xFF);
+  return frame;
+}
+
+// Request of the master: [0xAA,0x55,0x01,0x00,0x00,address,cc,fc,data_len,data...,crc_hi,crc_lo]
+static std::vector<uint8_t> make_solax_request(uint8_t address, uint8_t cc, uint8_t fc,
+                                               const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> frame = {0xAA, 0x55, 0x01, 0x00, 0x00, address, cc, fc, static_cast<uint8_t>(data.size())};
+  frame.insert(frame.end(), data.begin(), data.end());
+  uint16_t crc = solax_chksum(frame.data(), 9 + data.size() - 1);
   frame.push_back(crc >> 8);
   frame.push_back(crc & 0xFF);
   return frame;
@@ -34,33 +46,78 @@ static const std::vector<uint8_t> STATUS_FRAME_ADDR01 = make_solax_frame(0x01, 0
 // Frame with non-dispatch control code 0x10 from address=0x0A
 static const std::vector<uint8_t> WRONG_CC_FRAME = make_solax_frame(0x0A, 0x10, 0x02, {});
 
+static const uint8_t SERIAL_NUMBER_1[14] = {'X', 'M', 'U', '0', '6', '2', 'G', 'C', '0', '9', '3', '5', '4', '0'};
+static const uint8_t SERIAL_NUMBER_2[14] = {'X', 'M', 'U', '0', '6', '2', 'G', 'C', '0', '9', '3', '5', '4', '1'};
+
+// Reply of an unregistered inverter to the discovery broadcast
+static std::vector<uint8_t> make_discovery_reply(const uint8_t *serial_number) {
+  return make_solax_frame(0xFF, 0x10, 0x80, std::vector<uint8_t>(serial_number, serial_number + 14));
+}
+
 class MockSolaxModbusDevice : public SolaxModbusDevice {
  public:
   uint8_t last_function{0};
   std::vector<uint8_t> received_data;
   int call_count{0};
 
-  void on_solax_modbus_data(const uint8_t &function, const std::vector<uint8_t> &data) override {
+  uint8_t get_address() const { return this->address_; }
+
+  void on_solax_modbus_data(const uint8_t &function, const uint8_t *data, size_t len) override {
     last_function = function;
-    received_data = data;
+    received_data.assign(data, data + len);
+    call_count++;
+  }
+};
+
+// Doesn't copy the payload, so dispatching to it must not allocate
+class CountingSolaxModbusDevice : public SolaxModbusDevice {
+ public:
+  int call_count{0};
+  size_t last_len{0};
+
+  void on_solax_modbus_data(const uint8_t &function, const uint8_t *data, size_t len) override {
+    last_len = len;
     call_count++;
   }
 };
 
 class TestableSolaxModbus : public SolaxModbus {
  public:
+  std::vector<SolaxMessageT> sent;
+
   void loop() override {}
+  void send(SolaxMessageT *tx_message) override { sent.push_back(*tx_message); }
   using SolaxModbus::parse_solax_modbus_byte_;
+  using SolaxModbus::process_frames_;
+  using SolaxModbus::discard_stale_frames_;
+  using SolaxModbus::read_rx_;
+  using SolaxModbus::rx_pending_;
+
+  // What set_rx_wakeup_pin() enables, without a pin
+  void enable_rx_wakeup() { this->rx_wakeup_ = true; }
+  // An edge on the RX pin
+  void signal_rx() { SolaxModbus::gpio_intr(this); }
+  using SolaxModbus::process_transactions_;
+  using SolaxModbus::publish_statistics_;
+
+  uint32_t get_dropped_frames() const { return this->frames_.get_dropped(); }
 
   bool feed(const std::vector<uint8_t> &frame) {
     bool result = false;
     for (uint8_t byte : frame) {
       result = parse_solax_modbus_byte_(byte);
       if (!result)
-        this->rx_buffer_.clear();
+        this->rx_buffer_len_ = 0;
     }
     return result;
   }
+
+  // Simulates a single read_array() of everything available
+  bool feed_bulk(const std::vector<uint8_t> &bytes) {
+    memcpy(this->rx_buffer_ + this->rx_buffer_len_, bytes.data(), bytes.size());
+    this->rx_buffer_len_ += bytes.size();
+    return this->parse_rx_buffer_();
+  }
 };
 
 }  // namespace esphome::solax_modbus::testing
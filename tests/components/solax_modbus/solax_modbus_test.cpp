@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "common.h"
+#include "../allocation_counter.h"
 
 namespace esphome::solax_modbus::testing {
 
@@ -117,4 +118,603 @@ TEST(SolaxModbusTest, AddressMatchSelectsCorrectDevice) {
   EXPECT_EQ(device_01.call_count, 1);
 }
 
+TEST(SolaxModbusTest, PayloadPassedToDevice) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  modbus.feed(make_solax_frame(0x0A, 0x11, 0x82, {0x00, 0x21, 0x00, 0x02}));
+
+  ASSERT_EQ(device.received_data.size(), 4u);
+  EXPECT_EQ(device.received_data[1], 0x21);
+  EXPECT_EQ(device.received_data[3], 0x02);
+}
+
+TEST(SolaxModbusTest, MaximumDataLengthDispatched) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  modbus.feed(make_solax_frame(0x0A, 0x11, 0x82, std::vector<uint8_t>(255, 0x01)));
+
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(device.received_data.size(), 255u);
+}
+
+// Data length 247 made the 8 bit checksum index wrap before reaching the end
+TEST(SolaxModbusTest, DataLength247Dispatched) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> data(247);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = i;
+  modbus.feed_bulk(make_solax_frame(0x0A, 0x11, 0x82, data));
+
+  ASSERT_EQ(device.call_count, 1);
+  EXPECT_EQ(device.received_data, data);
+}
+
+// Data length 255 made the checksum length wrap and skip most of the payload
+TEST(SolaxModbusTest, DataLength255ChecksumCoversPayload) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> frame = make_solax_frame(0x0A, 0x11, 0x82, std::vector<uint8_t>(255, 0x5A));
+  modbus.feed_bulk(frame);
+  EXPECT_EQ(device.call_count, 1);
+
+  frame[SOLAX_HEADER_SIZE + 254] ^= 0x01;
+  modbus.feed_bulk(frame);
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(modbus.get_checksum_errors(), 1u);
+}
+
+TEST(SolaxModbusTest, BackToBackFramesInOneRead) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device_0a, device_01;
+  device_0a.set_address(0x0A);
+  device_01.set_address(0x01);
+  modbus.register_device(&device_0a);
+  modbus.register_device(&device_01);
+
+  std::vector<uint8_t> bytes = STATUS_FRAME;
+  bytes.insert(bytes.end(), STATUS_FRAME_ADDR01.begin(), STATUS_FRAME_ADDR01.end());
+  EXPECT_FALSE(modbus.feed_bulk(bytes));
+
+  EXPECT_EQ(device_0a.call_count, 1);
+  EXPECT_EQ(device_01.call_count, 1);
+}
+
+TEST(SolaxModbusTest, FrameSplitAcrossReads) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> bytes = STATUS_FRAME;
+  bytes.insert(bytes.end(), STATUS_FRAME.begin(), STATUS_FRAME.begin() + 5);
+  EXPECT_TRUE(modbus.feed_bulk(bytes));
+  EXPECT_EQ(device.call_count, 1);
+
+  EXPECT_FALSE(modbus.feed_bulk(std::vector<uint8_t>(STATUS_FRAME.begin() + 5, STATUS_FRAME.end())));
+  EXPECT_EQ(device.call_count, 2);
+}
+
+TEST(SolaxModbusTest, ResyncAfterLeadingNoise) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> bytes = {0x00, 0xAA, 0x13, 0x55};
+  bytes.insert(bytes.end(), STATUS_FRAME.begin(), STATUS_FRAME.end());
+  modbus.feed_bulk(bytes);
+
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(modbus.get_discarded_bytes(), 4u);
+}
+
+TEST(SolaxModbusTest, ResyncAfterBadChecksum) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> bytes = STATUS_FRAME;
+  bytes.back() ^= 0xFF;  // corrupt checksum
+  bytes.insert(bytes.end(), STATUS_FRAME.begin(), STATUS_FRAME.end());
+  EXPECT_FALSE(modbus.feed_bulk(bytes));
+
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(modbus.get_resync_count(), 1u);
+  EXPECT_EQ(modbus.get_discarded_bytes(), STATUS_FRAME.size());
+}
+
+TEST(SolaxModbusTest, ResyncIntoFrameHiddenByBogusLength) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  // Truncated header whose length byte swallows the start of the following good frames
+  std::vector<uint8_t> bytes = {0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0x02};
+  bytes.insert(bytes.end(), STATUS_FRAME.begin(), STATUS_FRAME.end());
+  bytes.insert(bytes.end(), STATUS_FRAME.begin(), STATUS_FRAME.end());
+  EXPECT_FALSE(modbus.feed_bulk(bytes));
+
+  EXPECT_EQ(device.call_count, 2);
+  EXPECT_EQ(modbus.get_resync_count(), 1u);
+  EXPECT_EQ(modbus.get_discarded_bytes(), 9u);
+}
+
+TEST(SolaxModbusTest, RequestsSentOneAtATime) {
+  TestableSolaxModbus modbus;
+  modbus.query_status_report(0x0A);
+  modbus.query_status_report(0x01);
+
+  modbus.process_transactions_(0);
+  modbus.process_transactions_(10);
+
+  ASSERT_EQ(modbus.sent.size(), 1u);
+  EXPECT_EQ(modbus.sent[0].Destination[1], 0x0A);
+  EXPECT_EQ(modbus.sent[0].FunctionCode, 0x02);
+}
+
+TEST(SolaxModbusTest, MatchingResponseSendsNextRequest) {
+  TestableSolaxModbus modbus;
+  modbus.query_status_report(0x0A);
+  modbus.query_status_report(0x01);
+  modbus.process_transactions_(0);
+
+  // A response of another device doesn't complete the transaction
+  modbus.feed(STATUS_FRAME_ADDR01);
+  modbus.process_transactions_(10);
+  EXPECT_EQ(modbus.sent.size(), 1u);
+
+  modbus.feed(make_solax_frame(0x0A, 0x11, 0x82, {}));
+  modbus.process_transactions_(20);
+  ASSERT_EQ(modbus.sent.size(), 2u);
+  EXPECT_EQ(modbus.sent[1].Destination[1], 0x01);
+}
+
+TEST(SolaxModbusTest, TimeoutSendsNextRequest) {
+  TestableSolaxModbus modbus;
+  modbus.set_response_timeout(250);
+  modbus.query_status_report(0x0A);
+  modbus.query_config_settings(0x0A);
+  modbus.process_transactions_(1000);
+
+  modbus.process_transactions_(1249);
+  EXPECT_EQ(modbus.sent.size(), 1u);
+
+  modbus.process_transactions_(1250);
+  ASSERT_EQ(modbus.sent.size(), 2u);
+  EXPECT_EQ(modbus.sent[1].FunctionCode, 0x04);
+}
+
+TEST(SolaxModbusTest, DuplicateRequestsQueuedOnce) {
+  TestableSolaxModbus modbus;
+  modbus.set_response_timeout(0);
+  modbus.query_status_report(0x0A);
+  modbus.query_status_report(0x0A);
+
+  modbus.process_transactions_(0);
+  modbus.process_transactions_(1);
+  modbus.process_transactions_(2);
+
+  EXPECT_EQ(modbus.sent.size(), 1u);
+}
+
+TEST(SolaxModbusTest, NoRequestSentWhileReceiving) {
+  TestableSolaxModbus modbus;
+  modbus.query_status_report(0x0A);
+
+  modbus.parse_solax_modbus_byte_(0xAA);
+  modbus.process_transactions_(0);
+  EXPECT_EQ(modbus.sent.size(), 0u);
+}
+
+TEST(SolaxModbusTest, RegisterAddressCarriesSerialNumber) {
+  TestableSolaxModbus modbus;
+  const uint8_t serial_number[14] = {0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+                                     0x37, 0x36, 0x35, 0x34, 0x33, 0x32, 0x31};
+  modbus.register_address(serial_number, 0x0A);
+  modbus.process_transactions_(0);
+
+  ASSERT_EQ(modbus.sent.size(), 1u);
+  EXPECT_EQ(modbus.sent[0].ControlCode, 0x10);
+  EXPECT_EQ(modbus.sent[0].FunctionCode, 0x01);
+  EXPECT_EQ(modbus.sent[0].DataLength, 0x0F);
+  EXPECT_EQ(memcmp(modbus.sent[0].Data, serial_number, 14), 0);
+  EXPECT_EQ(modbus.sent[0].Data[14], 0x0A);
+}
+
+// ── Discovery ─────────────────────────────────────────────────────────────────
+
+TEST(SolaxModbusDiscoveryTest, SerialNumberSelectsAddress) {
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("serial_number_selects_address");
+  MockSolaxModbusDevice device1, device2;
+  device1.set_address(0x0A);
+  device1.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_1));
+  device2.set_address(0x0B);
+  device2.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_2));
+  modbus.register_device(&device1);
+  modbus.register_device(&device2);
+  modbus.setup();
+
+  modbus.feed(make_discovery_reply(SERIAL_NUMBER_2));
+  modbus.process_transactions_(0);
+
+  ASSERT_EQ(modbus.sent.size(), 1u);
+  EXPECT_EQ(modbus.sent[0].FunctionCode, 0x01);
+  EXPECT_EQ(memcmp(modbus.sent[0].Data, SERIAL_NUMBER_2, 14), 0);
+  EXPECT_EQ(modbus.sent[0].Data[14], 0x0B);
+}
+
+TEST(SolaxModbusDiscoveryTest, UnknownSerialNumberNotRegistered) {
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("unknown_serial_number_not_registered");
+  MockSolaxModbusDevice device1, device2;
+  device1.set_address(0x0A);
+  device1.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_1));
+  device2.set_address(0x0B);
+  device2.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_1));
+  modbus.register_device(&device1);
+  modbus.register_device(&device2);
+  modbus.setup();
+
+  modbus.feed(make_discovery_reply(SERIAL_NUMBER_2));
+  modbus.process_transactions_(0);
+
+  EXPECT_EQ(modbus.sent.size(), 0u);
+}
+
+TEST(SolaxModbusDiscoveryTest, DuplicateAddressesMadeUnique) {
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("duplicate_addresses_made_unique");
+  MockSolaxModbusDevice device1, device2, device3;
+  device1.set_address(0x0A);
+  device2.set_address(0x0A);
+  device3.set_address(0x0B);
+  modbus.register_device(&device1);
+  modbus.register_device(&device2);
+  modbus.register_device(&device3);
+  modbus.setup();
+
+  EXPECT_EQ(device1.get_address(), 0x0A);
+  EXPECT_EQ(device2.get_address(), 0x0C);
+  EXPECT_EQ(device3.get_address(), 0x0B);
+}
+
+TEST(SolaxModbusDiscoveryTest, AddressMappingRestored) {
+  {
+    TestableSolaxModbus modbus;
+    modbus.set_discovery_key("address_mapping_restored");
+    MockSolaxModbusDevice device1, device2;
+    device1.set_address(0x0A);
+    device1.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_1));
+    device2.set_address(0x0B);
+    device2.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_2));
+    modbus.register_device(&device1);
+    modbus.register_device(&device2);
+    modbus.setup();
+
+    modbus.feed(make_discovery_reply(SERIAL_NUMBER_2));
+    modbus.feed(make_solax_frame(0x0B, 0x10, 0x81, {0x06}));
+    ASSERT_EQ(modbus.get_discovery().get_mappings().count, 1);
+    EXPECT_EQ(device2.call_count, 0);
+  }
+
+  // After a reboot the inverter gets its previous address, even if the devices accept any inverter
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("address_mapping_restored");
+  MockSolaxModbusDevice device1, device2;
+  device1.set_address(0x0A);
+  device2.set_address(0x0B);
+  modbus.register_device(&device1);
+  modbus.register_device(&device2);
+  modbus.setup();
+  ASSERT_EQ(modbus.get_discovery().get_mappings().count, 1);
+
+  modbus.feed(make_discovery_reply(SERIAL_NUMBER_2));
+  modbus.process_transactions_(0);
+
+  ASSERT_EQ(modbus.sent.size(), 1u);
+  EXPECT_EQ(modbus.sent[0].Data[14], 0x0B);
+}
+
+TEST(SolaxModbusDiscoveryTest, SeveralRegistrationsPending) {
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("several_registrations_pending");
+  MockSolaxModbusDevice device1, device2;
+  device1.set_address(0x0A);
+  device1.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_1));
+  device2.set_address(0x0B);
+  device2.set_serial_number(const_cast<uint8_t *>(SERIAL_NUMBER_2));
+  modbus.register_device(&device1);
+  modbus.register_device(&device2);
+  modbus.setup();
+
+  // Both inverters answer before either of them acknowledges its address
+  modbus.feed(make_discovery_reply(SERIAL_NUMBER_1));
+  modbus.feed(make_discovery_reply(SERIAL_NUMBER_2));
+  EXPECT_EQ(modbus.get_discovery().get_pending_count(), 2);
+
+  modbus.process_transactions_(0);
+  modbus.feed(make_solax_frame(0x0A, 0x10, 0x81, {0x06}));
+  modbus.process_transactions_(0);
+  modbus.feed(make_solax_frame(0x0B, 0x10, 0x81, {0x06}));
+
+  ASSERT_EQ(modbus.sent.size(), 2u);
+  EXPECT_EQ(modbus.sent[0].Data[14], 0x0A);
+  EXPECT_EQ(modbus.sent[1].Data[14], 0x0B);
+  EXPECT_EQ(modbus.get_discovery().get_pending_count(), 0);
+  EXPECT_EQ(modbus.get_discovery().get_mappings().count, 2);
+}
+
+TEST(SolaxModbusDiscoveryTest, CollisionBacksOff) {
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("collision_backs_off");
+  modbus.set_response_timeout(250);
+  modbus.setup();
+
+  modbus.discover_devices();
+  modbus.process_transactions_(1000);
+  ASSERT_EQ(modbus.sent.size(), 1u);
+
+  // Two replies on top of each other
+  std::vector<uint8_t> garbled = make_discovery_reply(SERIAL_NUMBER_1);
+  garbled[12] ^= 0x01;
+  modbus.feed(garbled);
+  modbus.process_transactions_(1250);
+
+  const SolaxDiscovery &discovery = modbus.get_discovery();
+  EXPECT_EQ(discovery.get_collisions(), 1u);
+  EXPECT_FALSE(discovery.is_discovery_allowed(2249));
+  EXPECT_TRUE(discovery.is_discovery_allowed(2250));
+}
+
+TEST(SolaxModbusDiscoveryTest, BackoffDoublesPerCollision) {
+  SolaxDiscovery discovery;
+  discovery.on_discovery_collision(0);
+  discovery.on_discovery_collision(1000);
+  EXPECT_FALSE(discovery.is_discovery_allowed(2999));
+  EXPECT_TRUE(discovery.is_discovery_allowed(3000));
+
+  for (int i = 0; i < 10; i++)
+    discovery.on_discovery_collision(10000);
+  EXPECT_TRUE(discovery.is_discovery_allowed(10000 + (DISCOVERY_BACKOFF_MIN << (DISCOVERY_BACKOFF_MAX_EXPONENT - 1))));
+
+  discovery.on_discovery_done(20000);
+  EXPECT_TRUE(discovery.is_discovery_allowed(20000));
+}
+
+TEST(SolaxModbusTest, DeviceTableFollowsReaddressing) {
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("device_table_follows_readdressing");
+  MockSolaxModbusDevice device1, device2;
+  device1.set_address(0x0A);
+  device2.set_address(0x0A);
+  modbus.register_device(&device1);
+  modbus.register_device(&device2);
+  modbus.setup();
+
+  modbus.feed(make_solax_frame(0x0B, 0x11, 0x82, {}));
+
+  EXPECT_EQ(device1.call_count, 0);
+  EXPECT_EQ(device2.call_count, 1);
+}
+
+TEST(SolaxModbusTest, UnknownAddressesCounted) {
+  TestableSolaxModbus modbus;
+  for (int i = 0; i < 5; i++)
+    modbus.feed(STATUS_FRAME);
+
+  EXPECT_EQ(modbus.get_unknown_addresses(), 5u);
+}
+
+// ── Listen-only mode ──────────────────────────────────────────────────────────
+
+TEST(SolaxModbusListenOnlyTest, NothingTransmitted) {
+  TestableSolaxModbus modbus;
+  modbus.set_listen_only(true);
+
+  modbus.query_status_report(0x0A);
+  modbus.query_config_settings(0x0A);
+  modbus.discover_devices();
+  modbus.process_transactions_(0);
+
+  EXPECT_EQ(modbus.sent.size(), 0u);
+}
+
+TEST(SolaxModbusListenOnlyTest, ObservedReplyDispatched) {
+  TestableSolaxModbus modbus;
+  modbus.set_listen_only(true);
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+  sensor::Sensor latency_max;
+  modbus.add_response_latency_sensors(0x0A, nullptr, nullptr, &latency_max, nullptr);
+
+  // The request of the other master isn't taken for a frame of address 0x00
+  modbus.feed(make_solax_request(0x0A, 0x11, 0x02, {}));
+  EXPECT_EQ(modbus.get_observed_requests(), 1u);
+  EXPECT_EQ(device.call_count, 0);
+  EXPECT_EQ(modbus.get_unknown_addresses(), 0u);
+
+  modbus.feed(make_solax_frame(0x0A, 0x11, 0x82, {0x01, 0x02}));
+  ASSERT_EQ(device.call_count, 1);
+  EXPECT_EQ(device.last_function, 0x82);
+
+  // The request/response pair shows up in the latency statistics
+  modbus.publish_statistics_();
+  EXPECT_TRUE(latency_max.has_state());
+}
+
+TEST(SolaxModbusListenOnlyTest, DiscoveredInverterNotRegistered) {
+  TestableSolaxModbus modbus;
+  modbus.set_discovery_key("listen_only_discovered_inverter_not_registered");
+  modbus.set_listen_only(true);
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+  modbus.setup();
+
+  modbus.feed(make_solax_request(0x00, 0x10, 0x00, {}));
+  modbus.feed(make_discovery_reply(SERIAL_NUMBER_1));
+  std::vector<uint8_t> registration(SERIAL_NUMBER_1, SERIAL_NUMBER_1 + 14);
+  registration.push_back(0x0A);
+  modbus.feed(make_solax_request(0x00, 0x10, 0x01, registration));
+  modbus.feed(make_solax_frame(0x0A, 0x10, 0x81, {0x06}));
+  modbus.process_transactions_(0);
+
+  EXPECT_EQ(modbus.sent.size(), 0u);
+  EXPECT_EQ(modbus.get_observed_requests(), 2u);
+  EXPECT_EQ(modbus.get_discovery().get_mappings().count, 0);
+  EXPECT_EQ(device.call_count, 0);
+}
+
+TEST(SolaxModbusTest, BusStatisticsCountErrors) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  std::vector<uint8_t> bad_checksum = STATUS_FRAME;
+  bad_checksum.back() ^= 0xFF;
+
+  std::vector<uint8_t> bytes = {0x00, 0x01};
+  bytes.insert(bytes.end(), bad_checksum.begin(), bad_checksum.end());
+  bytes.insert(bytes.end(), STATUS_FRAME.begin(), STATUS_FRAME.end());
+  bytes.insert(bytes.end(), STATUS_FRAME_ADDR01.begin(), STATUS_FRAME_ADDR01.end());
+  bytes.insert(bytes.end(), WRONG_CC_FRAME.begin(), WRONG_CC_FRAME.end());
+  modbus.feed_bulk(bytes);
+
+  EXPECT_EQ(modbus.get_frames_received(), 3u);
+  EXPECT_EQ(modbus.get_checksum_errors(), 1u);
+  EXPECT_EQ(modbus.get_header_errors(), 1u);
+  EXPECT_EQ(modbus.get_unknown_addresses(), 1u);
+  EXPECT_EQ(modbus.get_unhandled_control_codes(), 1u);
+
+  sensor::Sensor frames_received, checksum_errors;
+  modbus.set_frames_received_sensor(&frames_received);
+  modbus.set_checksum_errors_sensor(&checksum_errors);
+  modbus.publish_statistics_();
+
+  EXPECT_FLOAT_EQ(frames_received.state, 3.0f);
+  EXPECT_FLOAT_EQ(checksum_errors.state, 1.0f);
+}
+
+TEST(SolaxModbusTest, ResponseLatencyStatistics) {
+  TestableSolaxModbus modbus;
+  sensor::Sensor min, avg, max, p95;
+  modbus.add_response_latency_sensors(0x0A, &min, &avg, &max, &p95);
+
+  // Latencies of 10, 20, ..., 200 ms: each request is backdated by its latency
+  for (uint32_t latency = 10; latency <= 200; latency += 10) {
+    modbus.query_status_report(0x0A);
+    modbus.process_transactions_(millis() - latency);
+    modbus.feed(make_solax_frame(0x0A, 0x11, 0x82, {}));
+  }
+  modbus.publish_statistics_();
+
+  EXPECT_NEAR(min.state, 10.0f, 1.0f);
+  EXPECT_NEAR(avg.state, 105.0f, 1.0f);
+  EXPECT_NEAR(max.state, 200.0f, 1.0f);
+  EXPECT_NEAR(p95.state, 190.0f, 1.0f);
+}
+
+TEST(SolaxModbusTest, BusTaskDispatchesFromMainLoop) {
+  TestableSolaxModbus modbus;
+  modbus.set_bus_task(true);
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  const auto frame = make_solax_frame(0x0A, 0x11, 0x02, {0x01, 0x02, 0x03});
+  modbus.feed(frame);
+  EXPECT_EQ(device.call_count, 0);
+
+  modbus.process_frames_();
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(device.received_data, std::vector<uint8_t>({0x01, 0x02, 0x03}));
+}
+
+TEST(SolaxModbusTest, BusTaskDropsFramesWhenQueueFull) {
+  TestableSolaxModbus modbus;
+  modbus.set_bus_task(true);
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  for (uint8_t i = 0; i < SOLAX_FRAME_QUEUE_SIZE; i++)
+    modbus.feed(STATUS_FRAME);
+  EXPECT_EQ(modbus.get_dropped_frames(), 1u);
+
+  modbus.process_frames_();
+  EXPECT_EQ(device.call_count, SOLAX_FRAME_QUEUE_SIZE - 1);
+}
+
+TEST(SolaxModbusTest, LargeBogusLengthResyncsAfterGap) {
+  TestableSolaxModbus modbus;
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+
+  // The corrupted length byte announces 255 data bytes, more than the following good frame provides
+  std::vector<uint8_t> bytes = {0xAA, 0x55, 0x00, 0x0A, 0x01, 0x00, 0x11, 0x82, 0xFF};
+  bytes.insert(bytes.end(), STATUS_FRAME.begin(), STATUS_FRAME.end());
+  EXPECT_TRUE(modbus.feed_bulk(bytes));
+  EXPECT_EQ(device.call_count, 0);
+
+  // The inter-frame gap expires
+  modbus.discard_stale_frames_();
+  EXPECT_EQ(device.call_count, 1);
+  EXPECT_EQ(modbus.get_resync_count(), 1u);
+  EXPECT_EQ(modbus.get_discarded_bytes(), 9u);
+}
+
+TEST(SolaxModbusTest, RxWakeupSkipsParserOnIdleLine) {
+  TestableSolaxModbus modbus;
+  modbus.enable_rx_wakeup();
+  MockSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+  modbus.rx.assign(STATUS_FRAME.begin(), STATUS_FRAME.end());
+
+  modbus.read_rx_();
+  EXPECT_EQ(modbus.rx.size(), STATUS_FRAME.size());
+  EXPECT_EQ(device.call_count, 0);
+
+  modbus.signal_rx();
+  modbus.read_rx_();
+  EXPECT_TRUE(modbus.rx.empty());
+  EXPECT_EQ(device.call_count, 1);
+}
+
+TEST(SolaxModbusTest, ParseAndDispatchDoesNotAllocate) {
+  TestableSolaxModbus modbus;
+  CountingSolaxModbusDevice device;
+  device.set_address(0x0A);
+  modbus.register_device(&device);
+  const std::vector<uint8_t> frame = make_solax_frame(0x0A, 0x11, 0x82, std::vector<uint8_t>(50, 0x01));
+
+  size_t allocations_before = allocation_count;
+  for (int i = 0; i < 10; i++)
+    modbus.feed(frame);
+  size_t allocations = allocation_count - allocations_before;
+
+  EXPECT_EQ(device.call_count, 10);
+  EXPECT_EQ(device.last_len, 50u);
+  EXPECT_EQ(allocations, 0u);
+}
+
 }  // namespace esphome::solax_modbus::testing
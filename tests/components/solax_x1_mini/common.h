@@ -1,4 +1,8 @@
 #pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
 #include "esphome/components/solax_x1_mini/solax_x1_mini.h"
 
 namespace esphome::solax_x1_mini::testing {
@@ -6,6 +10,18 @@ namespace esphome::solax_x1_mini::testing {
 class TestableSolaxX1Mini : public SolaxX1Mini {
  public:
   void update() override {}
+  void run_update() { SolaxX1Mini::update(); }
+  using SolaxX1Mini::config_settings_due_;
+  using SolaxX1Mini::publish_device_offline_;
 };
 
+// G2 status frame with a patched mode (offset 30..31) and AC power (offset 18..19)
+static std::vector<uint8_t> make_status_frame(const std::vector<uint8_t> &frame, uint8_t mode, uint16_t ac_power) {
+  std::vector<uint8_t> patched = frame;
+  patched[18] = ac_power >> 8;
+  patched[19] = ac_power & 0xFF;
+  patched[31] = mode;
+  return patched;
+}
+
 }  // namespace esphome::solax_x1_mini::testing
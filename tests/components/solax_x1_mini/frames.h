@@ -19,4 +19,26 @@ static const std::vector<uint8_t> G2_STATUS_FRAME = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
 };
 
+// Source: solax_x1_mini.cpp comment, G3 status frame (data_len 0x38: 56 bytes)
+// temperature=26°C  energy_today=0.3kWh  dc1_voltage=103.6V  dc1_current=2.5A
+// ac_current=1.1A  ac_voltage=230.0V  ac_frequency=50.02Hz  ac_power=248W
+// energy_total=4.3kWh  runtime_total=13s  mode=2("Normal")  CT Pgrid=138W
+static const std::vector<uint8_t> G3_STATUS_FRAME = {
+    0x00, 0x1A, 0x00, 0x03, 0x04, 0x0C, 0x00, 0x00, 0x00, 0x19, 0x00, 0x00, 0x00, 0x0B, 0x08, 0xFC, 0x13, 0x8A, 0x00,
+    0xF8, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x2B, 0x00, 0x00, 0x00, 0x0D, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8A, 0x00, 0xDE,
+};
+
+// Config settings frame (data_len 0x44: 68 bytes)
+// pv_start_voltage=100.0V  start_time=60s  ac_voltage_protect=184.0..264.0V  ac_frequency_protect=47.50..51.50Hz
+// dci_limit=250mA  grid_average_voltage_protect=253.0V  ac_voltage_slow_protect=195.0..253.0V
+// ac_frequency_slow_protect=48.00..51.00Hz  safety=1(VDE4105)  power_factor_mode=1  power_limit=100%
+static const uint8_t FUNCTION_CONFIG_SETTINGS = 0x84;
+static const std::vector<uint8_t> CONFIG_SETTINGS_FRAME = {
+    0x03, 0xE8, 0x00, 0x3C, 0x07, 0x30, 0x0A, 0x50, 0x12, 0x8E, 0x14, 0x1E, 0x00, 0xFA, 0x09, 0xE2, 0x07,
+    0x9E, 0x09, 0xE2, 0x12, 0xC0, 0x13, 0xEC, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
 }  // namespace esphome::solax_x1_mini::testing
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "common.h"
 #include "frames.h"
 
@@ -11,7 +12,7 @@ TEST(SolaxX1MiniStatusTest, Temperature) {
   sensor::Sensor temp;
   bms.set_temperature_sensor(&temp);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_FLOAT_EQ(temp.state, 33.0f);
 }
@@ -25,7 +26,7 @@ TEST(SolaxX1MiniStatusTest, EnergyAndDcVoltage) {
   bms.set_dc1_current_sensor(&dc1a);
   bms.set_dc2_current_sensor(&dc2a);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_NEAR(energy_today.state, 0.2f, 0.01f);
   EXPECT_NEAR(dc1v.state, 202.8f, 0.1f);
@@ -42,7 +43,7 @@ TEST(SolaxX1MiniStatusTest, AcMeasurements) {
   bms.set_ac_frequency_sensor(&ac_freq);
   bms.set_ac_power_sensor(&ac_power);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_NEAR(ac_curr.state, 2.4f, 0.1f);
   EXPECT_NEAR(ac_volt.state, 238.9f, 0.1f);
@@ -55,7 +56,7 @@ TEST(SolaxX1MiniStatusTest, EnergyTotal) {
   sensor::Sensor energy_total;
   bms.set_energy_total_sensor(&energy_total);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_NEAR(energy_total.state, 2398.3f, 0.1f);
 }
@@ -65,7 +66,7 @@ TEST(SolaxX1MiniStatusTest, RuntimeTotal) {
   sensor::Sensor runtime;
   bms.set_runtime_total_sensor(&runtime);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_FLOAT_EQ(runtime.state, 4176.0f);
 }
@@ -75,7 +76,7 @@ TEST(SolaxX1MiniStatusTest, Mode) {
   sensor::Sensor mode;
   bms.set_mode_sensor(&mode);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_FLOAT_EQ(mode.state, 2.0f);
 }
@@ -85,7 +86,7 @@ TEST(SolaxX1MiniStatusTest, ModeText) {
   text_sensor::TextSensor mode_name;
   bms.set_mode_name_text_sensor(&mode_name);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_EQ(mode_name.state, "Normal");
 }
@@ -101,7 +102,7 @@ TEST(SolaxX1MiniStatusTest, FaultSensors) {
   bms.set_pv2_voltage_fault_sensor(&pv2_fault);
   bms.set_gfc_fault_sensor(&gfc_fault);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_NEAR(gv_fault.state, 0.0f, 0.01f);
   EXPECT_NEAR(gf_fault.state, 0.0f, 0.01f);
@@ -119,18 +120,498 @@ TEST(SolaxX1MiniStatusTest, ErrorBitsClean) {
   bms.set_error_bits_sensor(&error_bits);
   bms.set_errors_text_sensor(&errors);
 
-  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
 
   EXPECT_FLOAT_EQ(error_bits.state, 0.0f);
   EXPECT_EQ(errors.state, "");
 }
 
+TEST(SolaxX1MiniStatusTest, ErrorBitsText) {
+  TestableSolaxX1Mini bms;
+  text_sensor::TextSensor errors;
+  bms.set_errors_text_sensor(&errors);
+
+  auto frame = G2_STATUS_FRAME;
+  frame[46] = 0x06;  // Grid Lost Fault, Grid Voltage Fault
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(errors.state, "Grid Lost Fault;Grid Voltage Fault");
+
+  std::fill(frame.begin() + 46, frame.begin() + 50, 0xFF);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(errors.state.rfind("TZ Protect Fault;Grid Lost Fault;", 0), 0u);
+  const std::string tail = "Other Device Fault;Error (Bit 31)";
+  EXPECT_EQ(errors.state.substr(errors.state.size() - tail.size()), tail);
+}
+
+TEST(SolaxX1MiniStatusTest, TextSensorsPublishedOnChange) {
+  TestableSolaxX1Mini bms;
+  text_sensor::TextSensor mode_name, errors;
+  bms.set_mode_name_text_sensor(&mode_name);
+  bms.set_errors_text_sensor(&errors);
+
+  for (int i = 0; i < 3; i++)
+    bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
+  EXPECT_EQ(mode_name.publish_count, 1);
+  EXPECT_EQ(errors.publish_count, 1);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 3, 0);
+  frame[46] = 0x01;
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(mode_name.state, "Fault");
+  EXPECT_EQ(errors.state, "TZ Protect Fault");
+  EXPECT_EQ(mode_name.publish_count, 2);
+  EXPECT_EQ(errors.publish_count, 2);
+
+  // Going offline republishes everything on the next status report
+  bms.publish_device_offline_();
+  bms.publish_device_offline_();
+  EXPECT_EQ(mode_name.state, "Offline");
+  EXPECT_EQ(mode_name.publish_count, 3);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(mode_name.publish_count, 4);
+  EXPECT_EQ(errors.publish_count, 3);
+}
+
+// ── G3 status frame ───────────────────────────────────────────────────────────
+
+TEST(SolaxX1MiniStatusTest, G3Frame) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor temp, dc1v, ac_volt, ac_power, energy_total, runtime_total;
+  text_sensor::TextSensor mode_name;
+  bms.set_temperature_sensor(&temp);
+  bms.set_dc1_voltage_sensor(&dc1v);
+  bms.set_ac_voltage_sensor(&ac_volt);
+  bms.set_ac_power_sensor(&ac_power);
+  bms.set_energy_total_sensor(&energy_total);
+  bms.set_runtime_total_sensor(&runtime_total);
+  bms.set_mode_name_text_sensor(&mode_name);
+
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G3_STATUS_FRAME.data(), G3_STATUS_FRAME.size());
+
+  EXPECT_FLOAT_EQ(temp.state, 26.0f);
+  EXPECT_NEAR(dc1v.state, 103.6f, 0.1f);
+  EXPECT_NEAR(ac_volt.state, 230.0f, 0.1f);
+  EXPECT_NEAR(ac_power.state, 248.0f, 1.0f);
+  EXPECT_NEAR(energy_total.state, 4.3f, 0.01f);
+  EXPECT_FLOAT_EQ(runtime_total.state, 13.0f);
+  EXPECT_EQ(mode_name.state, "Normal");
+}
+
+TEST(SolaxX1MiniStatusTest, UnsupportedLengthIgnored) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor temp;
+  bms.set_temperature_sensor(&temp);
+
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G3_STATUS_FRAME.data(), G3_STATUS_FRAME.size() - 2);
+
+  EXPECT_FALSE(temp.has_state());
+}
+
+// ── Adaptive polling ──────────────────────────────────────────────────────────
+
+TEST(SolaxX1MiniAdaptivePollingTest, DisabledKeepsInterval) {
+  TestableSolaxX1Mini bms;
+  bms.set_update_interval(30000);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 0, 0);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+
+  EXPECT_EQ(bms.get_update_interval(), 30000u);
+}
+
+TEST(SolaxX1MiniAdaptivePollingTest, WaitModeRelaxesUpToMaximum) {
+  TestableSolaxX1Mini bms;
+  bms.set_update_interval(30000);
+  bms.set_adaptive_polling(5000, 100000, 50.0f);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 0, 0);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(bms.get_update_interval(), 60000u);
+
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(bms.get_update_interval(), 100000u);
+}
+
+TEST(SolaxX1MiniAdaptivePollingTest, OfflineRelaxes) {
+  TestableSolaxX1Mini bms;
+  bms.set_update_interval(30000);
+  bms.set_adaptive_polling(5000, 100000, 50.0f);
+
+  bms.publish_device_offline_();
+
+  EXPECT_EQ(bms.get_update_interval(), 60000u);
+}
+
+TEST(SolaxX1MiniAdaptivePollingTest, GoingOfflineIsNoPowerChange) {
+  TestableSolaxX1Mini bms;
+  bms.set_update_interval(30000);
+  bms.set_adaptive_polling(5000, 100000, 50.0f);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 2, 500);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  ASSERT_EQ(bms.get_update_interval(), 30000u);
+
+  bms.publish_device_offline_();
+  EXPECT_EQ(bms.get_update_interval(), 60000u);
+
+  // The first reading after the outage is not compared against the power before it
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(bms.get_update_interval(), 30000u);
+}
+
+TEST(SolaxX1MiniAdaptivePollingTest, PowerChangeTightensToMinimum) {
+  TestableSolaxX1Mini bms;
+  bms.set_update_interval(30000);
+  bms.set_adaptive_polling(5000, 100000, 50.0f);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 2, 500);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(bms.get_update_interval(), 30000u);
+
+  frame = make_status_frame(G2_STATUS_FRAME, 2, 300);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(bms.get_update_interval(), 5000u);
+}
+
+TEST(SolaxX1MiniAdaptivePollingTest, FlatPowerRelaxesToUpdateInterval) {
+  TestableSolaxX1Mini bms;
+  bms.set_update_interval(30000);
+  bms.set_adaptive_polling(5000, 100000, 50.0f);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 2, 500);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  frame = make_status_frame(G2_STATUS_FRAME, 2, 300);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  ASSERT_EQ(bms.get_update_interval(), 5000u);
+
+  frame = make_status_frame(G2_STATUS_FRAME, 2, 310);
+  for (int i = 0; i < 5; i++)
+    bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+
+  EXPECT_EQ(bms.get_update_interval(), 30000u);
+}
+
+TEST(SolaxX1MiniAdaptivePollingTest, LeavingWaitModeRestoresUpdateInterval) {
+  TestableSolaxX1Mini bms;
+  bms.set_update_interval(30000);
+  bms.set_adaptive_polling(5000, 100000, 50.0f);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 0, 0);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  ASSERT_EQ(bms.get_update_interval(), 100000u);
+
+  frame = make_status_frame(G2_STATUS_FRAME, 2, 20);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+
+  EXPECT_EQ(bms.get_update_interval(), 30000u);
+}
+
+// ── Deadband publishing ───────────────────────────────────────────────────────
+
+TEST(SolaxX1MiniPublishTest, PublishesEveryFrameByDefault) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor ac_power;
+  int publishes = 0;
+  ac_power.add_on_state_callback([&](float) { publishes++; });
+  bms.set_ac_power_sensor(&ac_power);
+
+  for (int i = 0; i < 3; i++)
+    bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
+
+  EXPECT_EQ(publishes, 3);
+}
+
+TEST(SolaxX1MiniPublishTest, UnchangedValuePublishedEveryNFrames) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor ac_power;
+  int publishes = 0;
+  ac_power.add_on_state_callback([&](float) { publishes++; });
+  bms.set_ac_power_sensor(&ac_power);
+  bms.set_publish_unchanged_every(10);
+
+  for (int i = 0; i < 20; i++)
+    bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
+
+  EXPECT_EQ(publishes, 2);
+}
+
+TEST(SolaxX1MiniPublishTest, ChangedValuePublishedImmediately) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor ac_power;
+  int publishes = 0;
+  ac_power.add_on_state_callback([&](float) { publishes++; });
+  bms.set_ac_power_sensor(&ac_power);
+  bms.set_publish_unchanged_every(10);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 2, 500);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  frame = make_status_frame(G2_STATUS_FRAME, 2, 501);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+
+  EXPECT_EQ(publishes, 2);
+  EXPECT_FLOAT_EQ(ac_power.state, 501.0f);
+}
+
+TEST(SolaxX1MiniPublishTest, ChangeWithinDeadbandSuppressed) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor ac_power;
+  int publishes = 0;
+  ac_power.add_on_state_callback([&](float) { publishes++; });
+  bms.set_ac_power_sensor(&ac_power);
+  bms.set_publish_unchanged_every(10);
+  bms.set_deadband(SLOT_AC_POWER, 10.0f);
+
+  for (uint16_t power : {500, 505, 495, 509}) {
+    auto frame = make_status_frame(G2_STATUS_FRAME, 2, power);
+    bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  }
+  EXPECT_EQ(publishes, 1);
+  EXPECT_FLOAT_EQ(ac_power.state, 500.0f);
+
+  auto frame = make_status_frame(G2_STATUS_FRAME, 2, 510);
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, frame.data(), frame.size());
+  EXPECT_EQ(publishes, 2);
+  EXPECT_FLOAT_EQ(ac_power.state, 510.0f);
+}
+
+TEST(SolaxX1MiniPublishTest, OfflineForcesNextPublish) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor ac_power;
+  bms.set_ac_power_sensor(&ac_power);
+  bms.set_publish_unchanged_every(10);
+
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
+  bms.publish_device_offline_();
+  EXPECT_FLOAT_EQ(ac_power.state, 0.0f);
+
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
+  EXPECT_NEAR(ac_power.state, 555.0f, 1.0f);
+}
+
+// ── History ───────────────────────────────────────────────────────────────────
+
+static StatusSample make_sample(uint32_t timestamp, uint16_t ac_power) {
+  StatusSample sample{};
+  sample.timestamp = timestamp;
+  sample.ac_power = ac_power;
+  sample.ac_voltage = 2389;
+  sample.dc1_current = 29;
+  sample.temperature = -5;
+  sample.mode = 2;
+  sample.error_bits = 0x00000402;
+  return sample;
+}
+
+static std::string export_history(const StatusHistory &history, HistoryFormat format, uint32_t now,
+                                  size_t chunk_size) {
+  HistoryExporter exporter(&history, format, now);
+  std::string result;
+  uint8_t buffer[64];
+  size_t len;
+  while ((len = exporter.read(buffer, chunk_size)) > 0)
+    result.append((const char *) buffer, len);
+  return result;
+}
+
+TEST(SolaxX1MiniHistoryTest, StatusReportRecorded) {
+  TestableSolaxX1Mini bms;
+  bms.set_history_capacity(10);
+  bms.setup();
+
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
+
+  const StatusHistory &history = bms.get_history();
+  ASSERT_EQ(history.get_size(), 1u);
+  const StatusSample &sample = history.get(0);
+  EXPECT_EQ(sample.ac_power, 555);
+  EXPECT_EQ(sample.ac_voltage, 2389);
+  EXPECT_EQ(sample.ac_current, 24);
+  EXPECT_EQ(sample.dc1_voltage, 2028);
+  EXPECT_EQ(sample.dc1_current, 29);
+  EXPECT_EQ(sample.dc2_voltage, 0);
+  EXPECT_EQ(sample.temperature, 33);
+  EXPECT_EQ(sample.mode, 2);
+  EXPECT_EQ(sample.error_bits, 0u);
+}
+
+TEST(SolaxX1MiniHistoryTest, RingBufferSpansBlocks) {
+  StatusHistory history;
+  ASSERT_EQ(history.allocate(HISTORY_BLOCK_SAMPLES + 14), HISTORY_BLOCK_SAMPLES + 14u);
+
+  for (uint32_t i = 0; i < 250; i++)
+    history.push(make_sample(i, 0));
+
+  EXPECT_EQ(history.get_size(), HISTORY_BLOCK_SAMPLES + 14u);
+  EXPECT_EQ(history.get_sequence(), 250u);
+  EXPECT_EQ(history.get(249).timestamp, 249u);
+  EXPECT_EQ(history.get(250 - history.get_size()).timestamp, 250u - history.get_size());
+}
+
+TEST(SolaxX1MiniHistoryTest, CsvExportInChunks) {
+  StatusHistory history;
+  history.allocate(10);
+  history.push(make_sample(1000, 555));
+  history.push(make_sample(11000, 560));
+
+  // The chunk size doesn't change the result
+  std::string csv = export_history(history, HISTORY_FORMAT_CSV, 21000, 7);
+  EXPECT_EQ(csv, export_history(history, HISTORY_FORMAT_CSV, 21000, 64));
+  EXPECT_EQ(csv,
+            "age_s,ac_power_w,ac_voltage_v,ac_current_a,dc1_voltage_v,dc1_current_a,dc2_voltage_v,dc2_current_a,"
+            "temperature_c,mode,error_bits\n"
+            "20,555,238.9,0.0,0.0,2.9,0.0,0.0,-5,2,0x00000402\n"
+            "10,560,238.9,0.0,0.0,2.9,0.0,0.0,-5,2,0x00000402\n");
+}
+
+TEST(SolaxX1MiniHistoryTest, BinaryExport) {
+  StatusHistory history;
+  history.allocate(10);
+  history.push(make_sample(1000, 555));
+  history.push(make_sample(11000, 560));
+
+  std::string binary = export_history(history, HISTORY_FORMAT_BINARY, 0x01020304, 5);
+  ASSERT_EQ(binary.size(), HISTORY_BINARY_HEADER_SIZE + 2 * sizeof(StatusSample));
+  EXPECT_EQ(binary.substr(0, HISTORY_BINARY_HEADER_SIZE), std::string("SXH\x01\x04\x03\x02\x01", 8));
+
+  StatusSample sample;
+  memcpy(&sample, binary.data() + HISTORY_BINARY_HEADER_SIZE + sizeof(StatusSample), sizeof(sample));
+  EXPECT_EQ(sample.timestamp, 11000u);
+  EXPECT_EQ(sample.ac_power, 560);
+}
+
+TEST(SolaxX1MiniHistoryTest, ExportSkipsOverwrittenSamples) {
+  StatusHistory history;
+  history.allocate(2);
+  history.push(make_sample(1000, 1));
+  history.push(make_sample(2000, 2));
+
+  HistoryExporter exporter(&history, HISTORY_FORMAT_BINARY, 3000);
+  uint8_t buffer[64];
+  ASSERT_EQ(exporter.read(buffer, HISTORY_BINARY_HEADER_SIZE + sizeof(StatusSample)),
+            HISTORY_BINARY_HEADER_SIZE + sizeof(StatusSample));
+
+  // The second sample was overwritten while the first one was sent, the new ones aren't part of the export
+  history.push(make_sample(3000, 3));
+  history.push(make_sample(4000, 4));
+  EXPECT_EQ(exporter.read(buffer, sizeof(buffer)), 0u);
+}
+
+TEST(SolaxX1MiniHistoryTest, ReadOnlyStoredSamples) {
+  StatusHistory history;
+  history.allocate(2);
+  for (uint32_t i = 0; i < 3; i++)
+    history.push(make_sample(i, 0));
+
+  StatusSample sample;
+  EXPECT_FALSE(history.read(0, &sample));
+  ASSERT_TRUE(history.read(1, &sample));
+  EXPECT_EQ(sample.timestamp, 1u);
+  ASSERT_TRUE(history.read(2, &sample));
+  EXPECT_EQ(sample.timestamp, 2u);
+  EXPECT_FALSE(history.read(3, &sample));
+}
+
+// ── Config settings ───────────────────────────────────────────────────────────
+
+TEST(SolaxX1MiniConfigTest, SensorsPublished) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor pv_start_voltage, ac_frequency_max, dci_limit, safety, power_factor_mode, power_limit;
+  bms.set_config_sensor(CONFIG_SLOT_PV_START_VOLTAGE, &pv_start_voltage);
+  bms.set_config_sensor(CONFIG_SLOT_AC_FREQUENCY_MAX_PROTECT, &ac_frequency_max);
+  bms.set_config_sensor(CONFIG_SLOT_DCI_LIMIT, &dci_limit);
+  bms.set_config_sensor(CONFIG_SLOT_SAFETY, &safety);
+  bms.set_config_sensor(CONFIG_SLOT_POWER_FACTOR_MODE, &power_factor_mode);
+  bms.set_config_sensor(CONFIG_SLOT_POWER_LIMIT, &power_limit);
+
+  bms.on_solax_modbus_data(FUNCTION_CONFIG_SETTINGS, CONFIG_SETTINGS_FRAME.data(), CONFIG_SETTINGS_FRAME.size());
+
+  EXPECT_FLOAT_EQ(pv_start_voltage.state, 100.0f);
+  EXPECT_FLOAT_EQ(ac_frequency_max.state, 51.5f);
+  EXPECT_FLOAT_EQ(dci_limit.state, 250.0f);
+  EXPECT_FLOAT_EQ(safety.state, 1.0f);
+  EXPECT_FLOAT_EQ(power_factor_mode.state, 1.0f);
+  EXPECT_FLOAT_EQ(power_limit.state, 100.0f);
+
+  const ConfigSettings &settings = bms.get_config_settings();
+  ASSERT_TRUE(settings.valid);
+  EXPECT_FLOAT_EQ(settings.values[CONFIG_SLOT_AC_VOLTAGE_MIN_SLOW_PROTECT], 195.0f);
+}
+
+TEST(SolaxX1MiniConfigTest, UnchangedFrameNotPublishedAgain) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor power_limit;
+  bms.set_config_sensor(CONFIG_SLOT_POWER_LIMIT, &power_limit);
+
+  bms.on_solax_modbus_data(FUNCTION_CONFIG_SETTINGS, CONFIG_SETTINGS_FRAME.data(), CONFIG_SETTINGS_FRAME.size());
+  bms.on_solax_modbus_data(FUNCTION_CONFIG_SETTINGS, CONFIG_SETTINGS_FRAME.data(), CONFIG_SETTINGS_FRAME.size());
+  EXPECT_EQ(power_limit.publish_count, 1);
+
+  std::vector<uint8_t> frame = CONFIG_SETTINGS_FRAME;
+  frame[43] = 80;
+  bms.on_solax_modbus_data(FUNCTION_CONFIG_SETTINGS, frame.data(), frame.size());
+  EXPECT_EQ(power_limit.publish_count, 2);
+  EXPECT_FLOAT_EQ(power_limit.state, 80.0f);
+}
+
+TEST(SolaxX1MiniConfigTest, InvalidSizeIgnored) {
+  TestableSolaxX1Mini bms;
+  sensor::Sensor power_limit;
+  bms.set_config_sensor(CONFIG_SLOT_POWER_LIMIT, &power_limit);
+
+  bms.on_solax_modbus_data(FUNCTION_CONFIG_SETTINGS, CONFIG_SETTINGS_FRAME.data(), CONFIG_SETTINGS_FRAME.size() - 2);
+
+  EXPECT_FALSE(power_limit.has_state());
+  EXPECT_FALSE(bms.get_config_settings().valid);
+}
+
+TEST(SolaxX1MiniConfigTest, FetchedOnlyWhenDue) {
+  TestableSolaxX1Mini bms;
+  EXPECT_FALSE(bms.config_settings_due_(0));
+
+  sensor::Sensor power_limit;
+  bms.set_config_sensor(CONFIG_SLOT_POWER_LIMIT, &power_limit);
+  bms.set_config_settings_interval(3600000);
+  EXPECT_TRUE(bms.config_settings_due_(0));
+
+  bms.on_solax_modbus_data(FUNCTION_CONFIG_SETTINGS, CONFIG_SETTINGS_FRAME.data(), CONFIG_SETTINGS_FRAME.size());
+  EXPECT_FALSE(bms.config_settings_due_(3599999));
+  EXPECT_TRUE(bms.config_settings_due_(3600000));
+}
+
+// ── Listen-only mode ──────────────────────────────────────────────────────────
+
+TEST(SolaxX1MiniListenOnlyTest, OfflineOnceStatusRepliesStop) {
+  solax_modbus::SolaxModbus bus;
+  bus.set_listen_only(true);
+  TestableSolaxX1Mini bms;
+  bms.set_parent(&bus);
+  sensor::Sensor mode;
+  bms.set_mode_sensor(&mode);
+
+  bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size());
+  for (uint8_t i = 0; i < REDISCOVERY_THRESHOLD - 1; i++)
+    bms.run_update();
+  EXPECT_FLOAT_EQ(mode.state, 2.0f);
+
+  bms.run_update();
+  EXPECT_FLOAT_EQ(mode.state, -1.0f);
+
+  // Offline is published once, not with every update
+  int publish_count = mode.publish_count;
+  bms.run_update();
+  bms.run_update();
+  EXPECT_EQ(mode.publish_count, publish_count);
+}
+
 // ── Null sensors do not crash ─────────────────────────────────────────────────
 
 TEST(SolaxX1MiniSafetyTest, NullSensorsDoNotCrash) {
   TestableSolaxX1Mini bms;
 
-  EXPECT_NO_FATAL_FAILURE(bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME));
+  EXPECT_NO_FATAL_FAILURE(bms.on_solax_modbus_data(FUNCTION_STATUS_REPORT, G2_STATUS_FRAME.data(), G2_STATUS_FRAME.size()));
 }
 
 }  // namespace esphome::solax_x1_mini::testing
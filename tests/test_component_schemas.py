@@ -28,6 +28,12 @@ class TestSolaxX1MiniSensorLists:
         assert "dc1_voltage" in sensor.SENSOR_DEFS
         assert len(sensor.SENSOR_DEFS) == 21
 
+    def test_config_sensor_defs_completeness(self):
+        assert "pv_start_voltage" in sensor.CONFIG_SENSOR_DEFS
+        assert "power_limit" in sensor.CONFIG_SENSOR_DEFS
+        assert len(sensor.CONFIG_SENSOR_DEFS) == 15
+        assert not set(sensor.CONFIG_SENSOR_DEFS) & set(sensor.SENSOR_DEFS)
+
 
 class TestSolaxX1MiniTextSensorConstants:
     def test_text_sensor_consts_defined(self):
@@ -38,11 +44,14 @@ class TestSolaxX1MiniTextSensorConstants:
 class TestSolaxMeterGatewaySensorDefs:
     def test_sensor_defs_completeness(self):
         assert gateway_sensor.CONF_POWER_DEMAND in gateway_sensor.SENSOR_DEFS
-        assert len(gateway_sensor.SENSOR_DEFS) == 1
+        assert len(gateway_sensor.SENSOR_DEFS) == 4
 
     def test_sensor_defs_keys_match_schema(self):
         assert set(gateway_sensor.SENSOR_DEFS.keys()) == {
-            gateway_sensor.CONF_POWER_DEMAND
+            gateway_sensor.CONF_POWER_DEMAND,
+            gateway_sensor.CONF_TURNAROUND_TIME,
+            gateway_sensor.CONF_ENERGY_IMPORT,
+            gateway_sensor.CONF_ENERGY_EXPORT,
         }
 
 